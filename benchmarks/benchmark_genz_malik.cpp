@@ -1,4 +1,5 @@
-#include "cubage/hypercube_integrator.hpp"
+#include "array_arithmetic.hpp"
+#include "hypercube_integrator.hpp"
 
 #include <chrono>
 #include <iostream>
@@ -56,7 +57,7 @@ void benchmark_genz_malik_gaussian(std::size_t num_iter)
 
     using Integrator = cubage::HypercubeIntegrator<std::array<double, NDIM>, double>;
     using Limits = typename Integrator::Limits;
-    using Result = typename Integrator::Result;
+    using Result = cubage::Result<typename Integrator::ResultType, cubage::Status>;
 
     std::array<double, NDIM> a{};
     std::array<double, NDIM> b{};
@@ -86,10 +87,75 @@ void benchmark_genz_malik_gaussian(std::size_t num_iter)
     std::cout << "Genz-Malik gaussian " << NDIM << "D: " << time << " us/iter\n";
 }
 
+/*
+    Compute the integral to progressively tighter tolerances, either from 
+    scratch at each tolerance, or by refining the result of the previous 
+    tolerance.
+*/
+template <std::size_t NDIM>
+void benchmark_genz_malik_gaussian_progressive(std::size_t num_iter)
+{
+    constexpr double sigma = 0.3;
+    auto function = [&](const std::array<double, NDIM>& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(std::accumulate(z2.begin(), z2.end(), 0.0)));
+    };
+
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, NDIM>, double>;
+    using Limits = typename Integrator::Limits;
+
+    std::array<double, NDIM> a{};
+    std::array<double, NDIM> b{};
+    for (auto& element : a)
+        element = -1.0;
+    for (auto& element : b)
+        element = 1.0;
+    const Limits limits = {a, b};
+
+    constexpr std::array<double, 5> abserrs = {
+        1.0e-3, 1.0e-4, 1.0e-5, 1.0e-6, 1.0e-7
+    };
+
+    Integrator integrator{};
+    double sink = 0.0;
+
+    auto bench_scratch = [&](){
+        for (std::size_t i = 0; i < num_iter; ++i)
+        {
+            for (const double abserr : abserrs)
+                sink += integrator.integrate(function, limits, abserr, 0.0).value.val;
+        }
+        return num_iter;
+    };
+
+    auto bench_refine = [&](){
+        for (std::size_t i = 0; i < num_iter; ++i)
+        {
+            sink += integrator.integrate(function, limits, abserrs[0], 0.0).value.val;
+            for (const double abserr : abserrs | std::views::drop(1))
+                sink += integrator.refine(function, abserr, 0.0).value.val;
+        }
+        return num_iter;
+    };
+
+    const double time_scratch = benchmark(bench_scratch);
+    const double time_refine = benchmark(bench_refine);
+
+    std::cout << "Genz-Malik gaussian " << NDIM << "D progressive: "
+        << time_scratch << " us/iter from scratch, "
+        << time_refine << " us/iter refined (" << sink << ")\n";
+}
+
 int main()
 {
     constexpr std::size_t num_iter = 10000;
     benchmark_genz_malik_gaussian<2>(num_iter);
     benchmark_genz_malik_gaussian<3>(num_iter);
     benchmark_genz_malik_gaussian<4>(num_iter);
+
+    benchmark_genz_malik_gaussian_progressive<2>(1000);
+    benchmark_genz_malik_gaussian_progressive<3>(100);
+    benchmark_genz_malik_gaussian_progressive<4>(10);
 }
\ No newline at end of file
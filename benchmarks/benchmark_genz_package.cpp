@@ -0,0 +1,396 @@
+#include "array_arithmetic.hpp"
+#include "hypercube_integrator.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <complex>
+#include <random>
+#include <utility>
+#include <cmath>
+#include <cstdlib>
+
+/*
+    Benchmark of the adaptive integrators on the test package of Genz [1]. The
+    package consists of six families of integrands on the unit hypercube,
+    each with a different kind of difficulty. The parameters of the integrands
+    are drawn at random and scaled such that the sum of the parameters `a_i`
+    is fixed for each family.
+
+    In dimensions 2-6, the hypercube rules of degree 7, 9 and 11 are compared
+    on the same integrands. For each family, dimension and integrator, the
+    benchmark reports the time per integration, the number of integrand and
+    region evaluations, the number of regions, the estimated and achieved
+    errors, and the peak memory used for storing the regions, as CSV or JSON.
+
+    Usage: benchmark_genz_package [csv|json] [relerr] [max_subdiv] [repeats]
+
+    [1] Genz, A. (1984). Testing multidimensional integration routines. In
+    Proc. of International Conference on Tools, Methods and Languages for
+    Scientific and Engineering Computation (pp. 81-94).
+*/
+
+enum class GenzFamily
+{
+    oscillatory,
+    product_peak,
+    corner_peak,
+    gaussian,
+    c0,
+    discontinuous
+};
+
+constexpr std::array<GenzFamily, 6> genz_families = {
+    GenzFamily::oscillatory, GenzFamily::product_peak,
+    GenzFamily::corner_peak, GenzFamily::gaussian, GenzFamily::c0,
+    GenzFamily::discontinuous
+};
+
+constexpr std::string_view family_name(GenzFamily family)
+{
+    switch (family)
+    {
+        case GenzFamily::oscillatory: return "oscillatory";
+        case GenzFamily::product_peak: return "product_peak";
+        case GenzFamily::corner_peak: return "corner_peak";
+        case GenzFamily::gaussian: return "gaussian";
+        case GenzFamily::c0: return "c0";
+        case GenzFamily::discontinuous: return "discontinuous";
+    }
+    return "";
+}
+
+// Sum of the parameters `a_i` of each family.
+constexpr double family_difficulty(GenzFamily family)
+{
+    switch (family)
+    {
+        case GenzFamily::oscillatory: return 9.0;
+        case GenzFamily::product_peak: return 7.25;
+        case GenzFamily::corner_peak: return 1.85;
+        case GenzFamily::gaussian: return 7.03;
+        case GenzFamily::c0: return 20.4;
+        case GenzFamily::discontinuous: return 4.3;
+    }
+    return 0.0;
+}
+
+template <std::size_t NDIM>
+struct GenzFunction
+{
+    GenzFamily family;
+    std::array<double, NDIM> a;
+    std::array<double, NDIM> u;
+
+    double operator()(const std::array<double, NDIM>& x) const
+    {
+        switch (family)
+        {
+            case GenzFamily::oscillatory:
+            {
+                double arg = 2.0*M_PI*u[0];
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    arg += a[i]*x[i];
+                return std::cos(arg);
+            }
+            case GenzFamily::product_peak:
+            {
+                double prod = 1.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    prod *= 1.0/(1.0/(a[i]*a[i]) + (x[i] - u[i])*(x[i] - u[i]));
+                return prod;
+            }
+            case GenzFamily::corner_peak:
+            {
+                double sum = 1.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    sum += a[i]*x[i];
+                return std::pow(sum, -double(NDIM + 1));
+            }
+            case GenzFamily::gaussian:
+            {
+                double sum = 0.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    sum += a[i]*a[i]*(x[i] - u[i])*(x[i] - u[i]);
+                return std::exp(-sum);
+            }
+            case GenzFamily::c0:
+            {
+                double sum = 0.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    sum += a[i]*std::fabs(x[i] - u[i]);
+                return std::exp(-sum);
+            }
+            case GenzFamily::discontinuous:
+            {
+                for (std::size_t i = 0; i < std::min(NDIM, std::size_t(2)); ++i)
+                    if (x[i] > u[i]) return 0.0;
+                double sum = 0.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    sum += a[i]*x[i];
+                return std::exp(sum);
+            }
+        }
+        return 0.0;
+    }
+
+    double exact() const
+    {
+        switch (family)
+        {
+            case GenzFamily::oscillatory:
+            {
+                std::complex<double> res = std::polar(1.0, 2.0*M_PI*u[0]);
+                for (std::size_t i = 0; i < NDIM; ++i)
+                {
+                    const std::complex<double> ia(0.0, a[i]);
+                    res *= (std::exp(ia) - 1.0)/ia;
+                }
+                return res.real();
+            }
+            case GenzFamily::product_peak:
+            {
+                double res = 1.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    res *= a[i]*(std::atan(a[i]*(1.0 - u[i])) + std::atan(a[i]*u[i]));
+                return res;
+            }
+            case GenzFamily::corner_peak:
+            {
+                // inclusion-exclusion over the vertices of the hypercube
+                double res = 0.0;
+                for (std::size_t v = 0; v < (std::size_t(1) << NDIM); ++v)
+                {
+                    double sum = 1.0;
+                    int sign = 1;
+                    for (std::size_t i = 0; i < NDIM; ++i)
+                    {
+                        if (v & (std::size_t(1) << i))
+                        {
+                            sum += a[i];
+                            sign = -sign;
+                        }
+                    }
+                    res += double(sign)/sum;
+                }
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    res /= double(i + 1)*a[i];
+                return res;
+            }
+            case GenzFamily::gaussian:
+            {
+                double res = 1.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    res *= 0.5*std::sqrt(M_PI)/a[i]
+                        *(std::erf(a[i]*(1.0 - u[i])) + std::erf(a[i]*u[i]));
+                return res;
+            }
+            case GenzFamily::c0:
+            {
+                double res = 1.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                    res *= (2.0 - std::exp(-a[i]*u[i])
+                        - std::exp(-a[i]*(1.0 - u[i])))/a[i];
+                return res;
+            }
+            case GenzFamily::discontinuous:
+            {
+                double res = 1.0;
+                for (std::size_t i = 0; i < NDIM; ++i)
+                {
+                    const double upper = (i < 2) ? u[i] : 1.0;
+                    res *= std::expm1(a[i]*upper)/a[i];
+                }
+                return res;
+            }
+        }
+        return 0.0;
+    }
+};
+
+template <std::size_t NDIM>
+GenzFunction<NDIM> make_genz_function(GenzFamily family, std::mt19937& gen)
+{
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    GenzFunction<NDIM> function{family, {}, {}};
+    double sum = 0.0;
+    for (std::size_t i = 0; i < NDIM; ++i)
+    {
+        function.a[i] = dist(gen);
+        function.u[i] = dist(gen);
+        sum += function.a[i];
+    }
+    for (auto& element : function.a)
+        element *= family_difficulty(family)/sum;
+    return function;
+}
+
+struct BenchmarkRecord
+{
+    std::string_view integrator;
+    std::string_view family;
+    std::size_t ndim;
+    double time;
+    std::size_t func_eval_count;
+    std::size_t region_eval_count;
+    std::size_t region_count;
+    double value;
+    double exact;
+    double estimated_error;
+    double error;
+    bool converged;
+    std::size_t peak_memory;
+};
+
+template <typename Integrator, typename FuncType, typename Limits>
+BenchmarkRecord benchmark_integrator(
+    std::string_view name, GenzFamily family, std::size_t ndim,
+    FuncType function, const Limits& limits, double exact, double relerr,
+    std::size_t max_subdiv, std::size_t repeats)
+{
+    using ResultType = typename Integrator::ResultType;
+
+    Integrator integrator{};
+    cubage::Result<ResultType, cubage::Status> result{};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < repeats; ++i)
+        result = integrator.integrate(function, limits, 0.0, relerr, max_subdiv);
+    const auto stop = std::chrono::steady_clock::now();
+    const double time = std::chrono::duration<double, std::micro>(
+            stop - start).count()/double(repeats);
+
+    // The region storage is reused across repeats, so its capacity is the peak
+    // number of regions of a single integration.
+    const std::size_t peak_memory = integrator.capacity()*Integrator::region_bytes;
+
+    return BenchmarkRecord{
+        name, family_name(family), ndim, time, integrator.func_eval_count(),
+        integrator.region_eval_count(), integrator.region_count(),
+        result.value.val, exact, result.value.err,
+        std::fabs(result.value.val - exact),
+        result.status == cubage::Status::SUCCESS, peak_memory
+    };
+}
+
+template <std::size_t NDIM>
+void benchmark_genz_function(
+    GenzFamily family, std::mt19937& gen, double relerr,
+    std::size_t max_subdiv, std::size_t repeats,
+    std::vector<BenchmarkRecord>& records)
+{
+    const GenzFunction<NDIM> function = make_genz_function<NDIM>(family, gen);
+    if constexpr (NDIM == 1)
+    {
+        using Integrator = cubage::IntervalIntegrator<double, double>;
+        auto scalar_function = [&](double x)
+        {
+            return function(std::array<double, 1>{x});
+        };
+        records.push_back(benchmark_integrator<Integrator>(
+            "IntervalIntegrator", family, NDIM, scalar_function,
+            typename Integrator::Limits{0.0, 1.0}, function.exact(), relerr,
+            max_subdiv, repeats));
+    }
+    else
+    {
+        using Integrator = cubage::HypercubeIntegrator<
+            std::array<double, NDIM>, double>;
+        std::array<double, NDIM> a{};
+        std::array<double, NDIM> b{};
+        for (auto& element : b)
+            element = 1.0;
+        const typename Integrator::Limits limits{a, b};
+        records.push_back(benchmark_integrator<Integrator>(
+            "HypercubeIntegrator", family, NDIM, function, limits,
+            function.exact(), relerr, max_subdiv, repeats));
+
+        // The higher degree rules are compared in the dimensions where their
+        // number of points stays moderate.
+        if constexpr (NDIM <= 6)
+        {
+            using Integrator9 = cubage::HypercubeIntegratorOfDegree<
+                std::array<double, NDIM>, double, 9>;
+            using Integrator11 = cubage::HypercubeIntegratorOfDegree<
+                std::array<double, NDIM>, double, 11>;
+            records.push_back(benchmark_integrator<Integrator9>(
+                "HypercubeIntegratorOfDegree<9>", family, NDIM, function,
+                limits, function.exact(), relerr, max_subdiv, repeats));
+            records.push_back(benchmark_integrator<Integrator11>(
+                "HypercubeIntegratorOfDegree<11>", family, NDIM, function,
+                limits, function.exact(), relerr, max_subdiv, repeats));
+        }
+    }
+}
+
+void print_csv(const std::vector<BenchmarkRecord>& records)
+{
+    std::cout << "integrator,family,ndim,time_us,func_eval_count,"
+        "region_eval_count,region_count,value,exact,estimated_error,error,"
+        "converged,peak_memory_bytes\n";
+    for (const auto& record : records)
+    {
+        std::cout << record.integrator << ',' << record.family << ','
+            << record.ndim << ',' << record.time << ','
+            << record.func_eval_count << ',' << record.region_eval_count << ','
+            << record.region_count << ',' << record.value << ','
+            << record.exact << ',' << record.estimated_error << ','
+            << record.error << ',' << record.converged << ','
+            << record.peak_memory << '\n';
+    }
+}
+
+void print_json(const std::vector<BenchmarkRecord>& records)
+{
+    std::cout << "[\n";
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const auto& record = records[i];
+        std::cout << "  {\"integrator\": \"" << record.integrator
+            << "\", \"family\": \"" << record.family
+            << "\", \"ndim\": " << record.ndim
+            << ", \"time_us\": " << record.time
+            << ", \"func_eval_count\": " << record.func_eval_count
+            << ", \"region_eval_count\": " << record.region_eval_count
+            << ", \"region_count\": " << record.region_count
+            << ", \"value\": " << record.value
+            << ", \"exact\": " << record.exact
+            << ", \"estimated_error\": " << record.estimated_error
+            << ", \"error\": " << record.error
+            << ", \"converged\": " << (record.converged ? "true" : "false")
+            << ", \"peak_memory_bytes\": " << record.peak_memory << '}'
+            << ((i + 1 < records.size()) ? ",\n" : "\n");
+    }
+    std::cout << "]\n";
+}
+
+int main(int argc, char** argv)
+{
+    const std::string_view format = (argc > 1) ? argv[1] : "csv";
+    const double relerr = (argc > 2) ? std::strtod(argv[2], nullptr) : 1.0e-6;
+    const std::size_t max_subdiv
+        = (argc > 3) ? std::strtoull(argv[3], nullptr, 10) : 10000;
+    const std::size_t repeats
+        = (argc > 4) ? std::strtoull(argv[4], nullptr, 10) : 3;
+
+    std::cout.precision(17);
+
+    std::mt19937 gen(5489u);
+    std::vector<BenchmarkRecord> records;
+    for (const GenzFamily family : genz_families)
+    {
+        [&]<std::size_t... NDIM>(std::index_sequence<NDIM...>)
+        {
+            (benchmark_genz_function<NDIM + 1>(
+                family, gen, relerr, max_subdiv, repeats, records), ...);
+        }(std::make_index_sequence<10>{});
+    }
+
+    if (format == "json")
+        print_json(records);
+    else
+        print_csv(records);
+}
@@ -22,6 +22,9 @@ SOFTWARE.
 #pragma once
 
 #include <array>
+#include <type_traits>
+
+#include "simd_kernels.hpp"
 
 template <typename T>
 concept ArithmeticAssignable = requires(T a, T b)
@@ -38,6 +41,15 @@ template <typename T>
 constexpr T& operator+=(
     T& a, const T& b) noexcept
 {
+    if constexpr (cubage::simd::Dispatched<T>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            cubage::simd::kernels().add(a.data(), b.data(), a.size());
+            return a;
+        }
+    }
+
     for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
         a[i] += b[i];
     return a;
@@ -60,6 +72,15 @@ template <typename T>
 constexpr T& operator-=(
     T& a, const T& b) noexcept
 {
+    if constexpr (cubage::simd::Dispatched<T>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            cubage::simd::kernels().subtract(a.data(), b.data(), a.size());
+            return a;
+        }
+    }
+
     for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
         a[i] -= b[i];
     return a;
@@ -81,6 +102,15 @@ template <typename T>
     ArithmeticAssignable<typename T::value_type>
 constexpr T& operator*=(T& a, const typename T::value_type& b) noexcept
 {
+    if constexpr (cubage::simd::Dispatched<T>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            cubage::simd::kernels().scale(a.data(), b, a.size());
+            return a;
+        }
+    }
+
     for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
         a[i] *= b;
     return a;
@@ -114,6 +144,15 @@ template <typename T>
 constexpr T& operator*=(
     T& a, const T& b) noexcept
 {
+    if constexpr (cubage::simd::Dispatched<T>)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            cubage::simd::kernels().multiply(a.data(), b.data(), a.size());
+            return a;
+        }
+    }
+
     for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
         a[i] *= b[i];
     return a;
@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <ranges>
+#include <concepts>
+#include <memory>
+#include <limits>
+
+#include "integral_result.hpp"
+#include "concepts.hpp"
+#include "thread_pool.hpp"
+#include "multi_integrator.hpp"
+
+namespace cubage
+{
+
+/*
+    Adaptive integrator for many integrands over the same domain.
+
+    Each integrand is integrated independently with its own convergence
+    criterion and status, exactly as a `MultiIntegrator` would integrate it.
+    The integrands are scheduled dynamically over `num_threads` threads. Each
+    thread owns one `MultiIntegrator`, which is reused for all integrands the
+    thread processes, so that the storage for the regions is allocated once
+    per thread rather than once per integrand. The result of each integrand
+    does not depend on the number of threads.
+
+    If `num_threads > 1`, distinct integrands are called concurrently, and
+    must therefore be safe to call concurrently.
+
+    If the integration of an integrand throws, e.g., because the limits are 
+    invalid or the integrand itself throws, no further integrands are 
+    started, and the first exception is rethrown once the running ones have
+    finished. An integrand must not call the `BatchIntegrator` integrating 
+    it, which throws `std::logic_error` if it has several threads.
+*/
+template <
+    typename RuleType, typename NormType = NormIndividual,
+    RegionQueue QueueType = BinaryHeapQueue>
+class BatchIntegrator
+{
+public:
+    using IntegratorType = MultiIntegrator<RuleType, NormType, QueueType>;
+    using Limits = typename IntegratorType::Limits;
+    using CodomainType = typename IntegratorType::CodomainType;
+    using DomainType = typename IntegratorType::DomainType;
+    using ResultType = typename IntegratorType::ResultType;
+
+    explicit BatchIntegrator(std::size_t num_threads = 1):
+        m_thread_pool((num_threads > 1) ?
+            std::make_unique<ThreadPool>(num_threads) : nullptr),
+        m_integrators((num_threads > 1) ? num_threads : 1),
+        m_region_eval_counts(m_integrators.size()),
+        m_func_eval_counts(m_integrators.size()) {}
+
+    /*
+        Integrate each function in `functions` over `integration_domain`. The
+        `i`th element of the returned vector is the result for the `i`th
+        function.
+    */
+    template <std::ranges::random_access_range FuncRange, typename LimitsType>
+        requires std::ranges::sized_range<FuncRange>
+            && Integrand<std::ranges::range_value_t<FuncRange>, DomainType, CodomainType>
+            && ValueOrSizedRangeOf<LimitsType, Limits>
+    [[nodiscard]] std::vector<Result<ResultType, Status>> integrate(
+            FuncRange&& functions, const LimitsType& integration_domain,
+            double abserr, double relerr,
+            std::size_t max_subdiv = std::numeric_limits<std::size_t>::max())
+    {
+        const auto first = std::ranges::begin(functions);
+        return integrate_indexed(std::ranges::size(functions),
+            [&](IntegratorType& integrator, std::size_t i)
+            {
+                return integrator.integrate(
+                    first[std::ranges::range_difference_t<FuncRange>(i)],
+                    integration_domain, abserr, relerr, max_subdiv);
+            });
+    }
+
+    /*
+        Integrate the parametrized function `f(x, param)` over
+        `integration_domain` for each `param` in `params`. The `i`th element
+        of the returned vector is the result for the `i`th parameter.
+    */
+    template <
+        typename FuncType, std::ranges::random_access_range ParamRange,
+        typename LimitsType>
+        requires std::ranges::sized_range<ParamRange>
+            && requires (
+                FuncType f, DomainType x,
+                std::ranges::range_reference_t<ParamRange> param)
+            {
+                { f(x, param) } -> std::same_as<CodomainType>;
+            }
+            && ValueOrSizedRangeOf<LimitsType, Limits>
+    [[nodiscard]] std::vector<Result<ResultType, Status>> integrate_parametric(
+            FuncType f, ParamRange&& params,
+            const LimitsType& integration_domain, double abserr, double relerr,
+            std::size_t max_subdiv = std::numeric_limits<std::size_t>::max())
+    {
+        const auto first = std::ranges::begin(params);
+        return integrate_indexed(std::ranges::size(params),
+            [&](IntegratorType& integrator, std::size_t i)
+            {
+                const auto& param
+                    = first[std::ranges::range_difference_t<ParamRange>(i)];
+                return integrator.integrate(
+                    [&f, &param](const DomainType& x) -> CodomainType
+                    {
+                        return f(x, param);
+                    },
+                    integration_domain, abserr, relerr, max_subdiv);
+            });
+    }
+
+    // Total number of integrand evaluations in the previous batch.
+    [[nodiscard]] std::size_t func_eval_count() const noexcept
+    {
+        std::size_t count = 0;
+        for (const std::size_t thread_count : m_func_eval_counts)
+            count += thread_count;
+        return count;
+    }
+
+    // Total number of region evaluations in the previous batch.
+    [[nodiscard]] std::size_t region_eval_count() const noexcept
+    {
+        std::size_t count = 0;
+        for (const std::size_t thread_count : m_region_eval_counts)
+            count += thread_count;
+        return count;
+    }
+
+private:
+    template <typename TaskType>
+    [[nodiscard]] std::vector<Result<ResultType, Status>>
+    integrate_indexed(std::size_t count, TaskType&& task)
+    {
+        std::vector<Result<ResultType, Status>> results(count);
+        std::ranges::fill(m_region_eval_counts, 0);
+        std::ranges::fill(m_func_eval_counts, 0);
+
+        auto integrate_one = [&](std::size_t i, std::size_t thread_index)
+        {
+            IntegratorType& integrator = m_integrators[thread_index];
+            results[i] = task(integrator, i);
+            m_region_eval_counts[thread_index]
+                += integrator.region_eval_count();
+            m_func_eval_counts[thread_index] += integrator.func_eval_count();
+        };
+
+        if (m_thread_pool)
+            m_thread_pool->for_each_index(count, integrate_one);
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                integrate_one(i, 0);
+        }
+
+        return results;
+    }
+
+    std::unique_ptr<ThreadPool> m_thread_pool;
+    std::vector<IntegratorType> m_integrators;
+    std::vector<std::size_t> m_region_eval_counts;
+    std::vector<std::size_t> m_func_eval_counts;
+};
+
+}
\ No newline at end of file
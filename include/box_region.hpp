@@ -29,6 +29,7 @@ SOFTWARE.
 #include <compare>
 
 #include "concepts.hpp"
+#include "simd_kernels.hpp"
 
 namespace cubage
 {
@@ -38,6 +39,11 @@ template <typename FieldType>
 struct Box
 {
     using value_type = typename FieldType::value_type;
+
+    // The volume is computed in at least double precision, so that the 
+    // weights of a rule over a box of floats are not rounded to float.
+    using volume_type = std::common_type_t<value_type, double>;
+
     FieldType xmin;
     FieldType xmax;
 
@@ -46,17 +52,22 @@ struct Box
         return xmax - xmin;
     }
 
-    [[nodiscard]] constexpr value_type volume() const noexcept
+    [[nodiscard]] constexpr volume_type volume() const noexcept
     {
         FieldType lengths = side_lengths();
+        if constexpr (simd::Dispatched<FieldType>)
+        {
+            if (!std::is_constant_evaluated())
+                return simd::kernels().product(lengths.data(), lengths.size());
+        }
         return std::accumulate(
-                lengths.begin(), lengths.end(), 1.0,
-                std::multiplies<value_type>());
+                lengths.begin(), lengths.end(), volume_type(1),
+                std::multiplies<volume_type>());
     }
 
     [[nodiscard]] constexpr FieldType center() const noexcept
     {
-        return 0.5*(xmax + xmin);
+        return value_type(0.5)*(xmax + xmin);
     }
 
     [[nodiscard]] constexpr std::pair<FieldType, FieldType>
@@ -65,7 +76,8 @@ struct Box
         FieldType xmax_first = xmax;
         FieldType xmin_second = xmin;
 
-        const auto mid = 0.5*(xmin[subdiv_axis] + xmax[subdiv_axis]);
+        const value_type mid
+            = value_type(0.5)*(xmin[subdiv_axis] + xmax[subdiv_axis]);
         xmax_first[subdiv_axis] = mid;
         xmin_second[subdiv_axis] = mid;
 
@@ -122,19 +134,122 @@ public:
     }
 
     template <typename Rule, typename FuncType>
-        requires MapsAs<FuncType, DomainType, typename Rule::CodomainType>
+        requires Integrand<FuncType, DomainType, typename Rule::CodomainType>
         && BoxIntegratorSignature<Rule>
     [[nodiscard]] constexpr const IntegralResult<typename Rule::CodomainType> 
-    integrate(FuncType f) noexcept
+    integrate(FuncType f)
     {
         const auto& [res, axis] = Rule::integrate(f, m_limits);
         m_subdiv_axis = axis;
         return res;
     }
 
+    // Variant for rules which evaluate the points of a box in parallel on 
+    // `pool`.
+    template <typename Rule, typename FuncType, typename PoolType>
+        requires BoxIntegratorSignature<Rule>
+            && requires (FuncType f, const Limits& limits, PoolType& pool)
+            {
+                Rule::integrate(f, limits, pool);
+            }
+    [[nodiscard]] const IntegralResult<typename Rule::CodomainType> 
+    integrate(FuncType f, PoolType& pool)
+    {
+        const auto& [res, axis] = Rule::integrate(f, m_limits, pool);
+        m_subdiv_axis = axis;
+        return res;
+    }
+
+private:
+    Limits m_limits{};
+    std::size_t m_subdiv_axis{};
+};
+
+template <typename FieldType>
+concept NestedBoxIntegratorSignature
+= requires (
+    typename FieldType::CodomainType (*f)(typename FieldType::DomainType),
+    typename FieldType::Limits limits,
+    typename FieldType::NodeValues& values,
+    std::size_t parent_axis, int parent_side)
+{
+    { FieldType::integrate(f, limits, values, parent_axis, parent_side) } -> std::same_as<std::pair<IntegralResult<typename FieldType::CodomainType>, std::size_t>>;
+};
+
+/*
+    Box, which stores function values needed by the halves of the box when it
+    is subdivided, for rules whose points partially coincide with the points
+    of the rule on either half of the box. The halves inherit the values of
+    the parent together with the subdivision axis and the side of the parent
+    they lie on (-1 for the lower half, +1 for the upper half), from which the
+    rule determines which of its points are already known.
+*/
+template <typename Domain, typename Codomain, std::size_t ValueCount>
+    requires ArrayLike<Domain>
+class NestedSubdivisibleBox
+{
+public:
+    using DomainType = Domain;
+    using CodomainType = Codomain;
+    using Limits = Box<DomainType>;
+
+    constexpr NestedSubdivisibleBox() = default;
+
+    constexpr NestedSubdivisibleBox(
+        const DomainType& p_xmin, const DomainType& p_xmax):
+        NestedSubdivisibleBox(Limits{p_xmin, p_xmax}) {}
+
+    explicit constexpr NestedSubdivisibleBox(const Limits& p_limits):
+        m_limits(p_limits)
+    {
+        const auto sides = m_limits.side_lengths();
+        for (const auto side : sides)
+            if (side <= 0)
+                throw std::invalid_argument(
+                        "invalid integration limits: max <= min");
+    }
+
+    [[nodiscard]] constexpr const Limits&
+    limits() const noexcept { return m_limits; }
+
+    [[nodiscard]] constexpr std::pair<NestedSubdivisibleBox, NestedSubdivisibleBox>
+    subdivide() const noexcept
+    {
+        const auto& [xmax_first, xmin_second] = m_limits.subdivide(m_subdiv_axis);
+
+        std::pair<NestedSubdivisibleBox, NestedSubdivisibleBox> boxes = {
+            NestedSubdivisibleBox(m_limits.xmin, xmax_first),
+            NestedSubdivisibleBox(xmin_second, m_limits.xmax)
+        };
+
+        boxes.first.m_values = m_values;
+        boxes.second.m_values = m_values;
+        boxes.first.m_parent_axis = m_subdiv_axis;
+        boxes.second.m_parent_axis = m_subdiv_axis;
+        boxes.first.m_parent_side = -1;
+        boxes.second.m_parent_side = 1;
+
+        return boxes;
+    }
+
+    template <typename Rule, typename FuncType>
+        requires MapsAs<FuncType, DomainType, typename Rule::CodomainType>
+            && NestedBoxIntegratorSignature<Rule>
+    [[nodiscard]] constexpr const IntegralResult<typename Rule::CodomainType> 
+    integrate(FuncType f)
+    {
+        const auto& [res, axis] = Rule::integrate(
+                f, m_limits, m_values, m_parent_axis, m_parent_side);
+        m_subdiv_axis = axis;
+        return res;
+    }
+
 private:
     Limits m_limits{};
+    std::array<CodomainType, ValueCount> m_values{};
     std::size_t m_subdiv_axis{};
+    std::size_t m_parent_axis{};
+    int m_parent_side = 0;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,230 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <cstdint>
+
+namespace cubage
+{
+
+/*
+    Helpers for the binary checkpoint format of `MultiIntegrator`.
+
+    A checkpoint starts with a header consisting of an 8 byte magic string, a 
+    32-bit format version, a tag identifying the region type, the sizes of the
+    region and result types, and the number of dimensions and of evaluation 
+    points per region of the rule. The last two are zero if they depend on the
+    region. The header is followed by the raw bytes of the integrator state. 
+    All values are stored in the native byte order, so checkpoints are meant 
+    to be restored on the machine, or at least the architecture, that wrote 
+    them.
+*/
+inline constexpr std::array<char, 8> checkpoint_magic
+    = {'C', 'U', 'B', 'A', 'G', 'E', 'C', 'K'};
+inline constexpr std::uint32_t checkpoint_version = 3;
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void write_binary(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void read_binary(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in)
+        throw std::runtime_error("invalid checkpoint: unexpected end of data");
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void write_binary(std::ostream& out, const std::vector<T>& values)
+{
+    write_binary(out, std::uint64_t(values.size()));
+    out.write(
+            reinterpret_cast<const char*>(values.data()),
+            std::streamsize(values.size()*sizeof(T)));
+}
+
+/*
+    Number of bytes left to read from `in`, or the largest representable 
+    number if the stream cannot seek.
+*/
+inline std::uint64_t remaining_bytes(std::istream& in)
+{
+    constexpr std::uint64_t unknown = std::numeric_limits<std::uint64_t>::max();
+    const std::istream::pos_type position = in.tellg();
+    if (position == std::istream::pos_type(-1))
+        return unknown;
+
+    in.seekg(0, std::ios::end);
+    const std::istream::pos_type end = in.tellg();
+    in.clear();
+    in.seekg(position);
+    if (!in || end == std::istream::pos_type(-1) || end < position)
+        throw std::runtime_error("invalid checkpoint: cannot determine its size");
+
+    return std::uint64_t(end - position);
+}
+
+/*
+    Read the number of elements of type `T` that follow in the checkpoint, and
+    check that they fit into the rest of the stream before anything is 
+    allocated for them.
+*/
+template <typename T>
+[[nodiscard]] std::size_t read_element_count(std::istream& in)
+{
+    std::uint64_t count;
+    read_binary(in, count);
+    if (count > remaining_bytes(in)/sizeof(T)
+            || count > std::numeric_limits<std::size_t>::max()/sizeof(T))
+        throw std::runtime_error("invalid checkpoint: element count exceeds data");
+
+    return std::size_t(count);
+}
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void read_binary(std::istream& in, std::vector<T>& values)
+{
+    values.resize(read_element_count<T>(in));
+    in.read(
+            reinterpret_cast<char*>(values.data()),
+            std::streamsize(values.size()*sizeof(T)));
+    if (!in)
+        throw std::runtime_error("invalid checkpoint: unexpected end of data");
+}
+
+/*
+    Number of dimensions of the domain of `Rule`, or zero if it is only known
+    at runtime.
+*/
+template <typename Rule>
+[[nodiscard]] constexpr std::uint64_t checkpoint_ndim() noexcept
+{
+    using DomainType = typename Rule::DomainType;
+    if constexpr (std::is_arithmetic_v<DomainType>)
+        return 1;
+    else if constexpr (requires { std::tuple_size<DomainType>::value; })
+        return std::tuple_size<DomainType>::value;
+    else
+        return 0;
+}
+
+/*
+    Number of evaluation points per region of `Rule`, or zero if it depends on
+    the region.
+*/
+template <typename Rule>
+[[nodiscard]] constexpr std::uint64_t checkpoint_points_count() noexcept
+{
+    if constexpr (requires { Rule::points_count(); })
+        return Rule::points_count();
+    else
+        return 0;
+}
+
+/*
+    Tag identifying `T`, computed as the 64-bit FNV-1a hash of its 
+    implementation-defined name. It is stable across runs of programs built 
+    with the same compiler ABI.
+*/
+template <typename T>
+[[nodiscard]] std::uint64_t checkpoint_type_tag() noexcept
+{
+    std::uint64_t hash = 0xcbf29ce484222325;
+    for (const char c : std::string_view(typeid(T).name()))
+    {
+        hash ^= std::uint64_t(static_cast<unsigned char>(c));
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
+/*
+    `Region` is the `IntegrationRegion` of the rule, whose subdivisible 
+    regions and results are stored in the checkpoint.
+*/
+template <typename Region>
+void write_checkpoint_header(std::ostream& out)
+{
+    using RuleType = typename Region::RuleType;
+    write_binary(out, checkpoint_magic);
+    write_binary(out, checkpoint_version);
+    write_binary(out, checkpoint_type_tag<Region>());
+    write_binary(out, std::uint32_t(sizeof(typename Region::RegionType)));
+    write_binary(out, std::uint32_t(sizeof(typename Region::Result)));
+    write_binary(out, checkpoint_ndim<RuleType>());
+    write_binary(out, checkpoint_points_count<RuleType>());
+}
+
+template <typename Region>
+void read_checkpoint_header(std::istream& in)
+{
+    using RuleType = typename Region::RuleType;
+    std::array<char, 8> magic;
+    read_binary(in, magic);
+    if (magic != checkpoint_magic)
+        throw std::runtime_error("invalid checkpoint: bad magic string");
+
+    std::uint32_t version;
+    read_binary(in, version);
+    if (version != checkpoint_version)
+        throw std::runtime_error("invalid checkpoint: unsupported version");
+
+    std::uint64_t type_tag;
+    std::uint32_t region_size;
+    std::uint32_t result_size;
+    std::uint64_t ndim;
+    std::uint64_t points_count;
+    read_binary(in, type_tag);
+    read_binary(in, region_size);
+    read_binary(in, result_size);
+    read_binary(in, ndim);
+    read_binary(in, points_count);
+    if (type_tag != checkpoint_type_tag<Region>()
+            || region_size != sizeof(typename Region::RegionType)
+            || result_size != sizeof(typename Region::Result))
+        throw std::runtime_error(
+                "invalid checkpoint: written by an integrator of different type");
+
+    if (ndim != checkpoint_ndim<RuleType>()
+            || points_count != checkpoint_points_count<RuleType>())
+        throw std::runtime_error(
+                "invalid checkpoint: written by a different rule");
+}
+
+}
\ No newline at end of file
@@ -22,6 +22,7 @@ SOFTWARE.
 #pragma once
 
 #include <concepts>
+#include <span>
 #include "integral_result.hpp"
 
 namespace cubage
@@ -32,4 +33,20 @@ concept MapsAs = requires (F f, DomainType x)
 {
     { f(x) } -> std::same_as<CodomainType>; 
 };
+
+/*
+    Batched integrand, which evaluates the function at all points of `x` in
+    one call and writes the values to the corresponding elements of `y`.
+*/
+template <typename F, typename DomainType, typename CodomainType>
+concept BatchMapsAs = requires (
+    F f, std::span<const DomainType> x, std::span<CodomainType> y)
+{
+    f(x, y);
+};
+
+template <typename F, typename DomainType, typename CodomainType>
+concept Integrand = MapsAs<F, DomainType, CodomainType>
+    || BatchMapsAs<F, DomainType, CodomainType>;
+
 }
\ No newline at end of file
@@ -0,0 +1,354 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <span>
+#include <bit>
+#include <algorithm>
+#include <stdexcept>
+
+#include "integral_result.hpp"
+#include "concepts.hpp"
+#include "genz_malik.hpp"
+
+namespace cubage
+{
+
+/*
+    Box whose dimension is only known at runtime. The limits are stored 
+    inline for up to `MaxNdim` dimensions, so that boxes of any dimension up 
+    to `MaxNdim` have the same size and can be stored contiguously.
+*/
+template <std::size_t MaxNdim>
+class DynamicBox
+{
+public:
+    constexpr DynamicBox() = default;
+
+    constexpr DynamicBox(
+        std::span<const double> p_xmin, std::span<const double> p_xmax):
+        m_ndim(p_xmin.size())
+    {
+        if (p_xmax.size() != m_ndim)
+            throw std::invalid_argument(
+                    "invalid integration limits: xmin and xmax differ in size");
+        if (m_ndim < 2 || m_ndim > MaxNdim)
+            throw std::invalid_argument(
+                    "invalid integration limits: unsupported dimension");
+        std::ranges::copy(p_xmin, m_xmin.begin());
+        std::ranges::copy(p_xmax, m_xmax.begin());
+    }
+
+    [[nodiscard]] constexpr std::size_t ndim() const noexcept { return m_ndim; }
+
+    [[nodiscard]] constexpr std::span<const double> xmin() const noexcept
+    {
+        return std::span(m_xmin).first(m_ndim);
+    }
+
+    [[nodiscard]] constexpr std::span<const double> xmax() const noexcept
+    {
+        return std::span(m_xmax).first(m_ndim);
+    }
+
+    [[nodiscard]] constexpr double volume() const noexcept
+    {
+        double res = 1.0;
+        for (std::size_t i = 0; i < m_ndim; ++i)
+            res *= m_xmax[i] - m_xmin[i];
+        return res;
+    }
+
+    [[nodiscard]] constexpr std::pair<DynamicBox, DynamicBox>
+    subdivide(std::size_t subdiv_axis) const noexcept
+    {
+        std::pair<DynamicBox, DynamicBox> boxes = {*this, *this};
+        const double mid = 0.5*(m_xmin[subdiv_axis] + m_xmax[subdiv_axis]);
+        boxes.first.m_xmax[subdiv_axis] = mid;
+        boxes.second.m_xmin[subdiv_axis] = mid;
+        return boxes;
+    }
+
+private:
+    std::array<double, MaxNdim> m_xmin{};
+    std::array<double, MaxNdim> m_xmax{};
+    std::size_t m_ndim{};
+};
+
+/*
+    Subdivisible box for rules over `DynamicBox`, analogous to 
+    `SubdivisibleBox`.
+*/
+template <std::size_t MaxNdim>
+class DynamicSubdivisibleBox
+{
+public:
+    using DomainType = std::span<const double>;
+    using Limits = DynamicBox<MaxNdim>;
+
+    constexpr DynamicSubdivisibleBox() = default;
+
+    explicit constexpr DynamicSubdivisibleBox(const Limits& p_limits):
+        m_limits(p_limits)
+    {
+        for (std::size_t i = 0; i < m_limits.ndim(); ++i)
+            if (m_limits.xmax()[i] <= m_limits.xmin()[i])
+                throw std::invalid_argument(
+                        "invalid integration limits: max <= min");
+    }
+
+    [[nodiscard]] constexpr const Limits&
+    limits() const noexcept { return m_limits; }
+
+    [[nodiscard]] constexpr std::pair<DynamicSubdivisibleBox, DynamicSubdivisibleBox>
+    subdivide() const noexcept
+    {
+        const auto& [first, second] = m_limits.subdivide(m_subdiv_axis);
+        std::pair<DynamicSubdivisibleBox, DynamicSubdivisibleBox> boxes;
+        boxes.first.m_limits = first;
+        boxes.second.m_limits = second;
+        return boxes;
+    }
+
+    template <typename Rule, typename FuncType>
+        requires MapsAs<FuncType, DomainType, typename Rule::CodomainType>
+            && BoxIntegratorSignature<Rule>
+    [[nodiscard]] constexpr const IntegralResult<typename Rule::CodomainType>
+    integrate(FuncType f)
+    {
+        const auto& [res, axis] = Rule::integrate(f, m_limits);
+        m_subdiv_axis = axis;
+        return res;
+    }
+
+private:
+    Limits m_limits{};
+    std::size_t m_subdiv_axis{};
+};
+
+/*
+    Genz-Malik rule of degree 7 for domains whose dimension is only known at
+    runtime, with the generators and weights of `GenzMalikD7`. The points are
+    passed to the integrand as `std::span<const double>`, and the limits are 
+    given as a `DynamicBox` of up to `MaxNdim` dimensions. The rule and its 
+    regions can therefore be used with `MultiIntegrator` like any other rule, 
+    see `DynamicHypercubeIntegrator`.
+
+    The rule is dispatched on the dimension to implementations whose loops 
+    have a compile-time trip count for dimensions up to `max_specialized_ndim`,
+    and to a generic implementation above that, so that only one rule needs
+    to be instantiated for all dimensions.
+
+    Since the number of points grows as 2^n, the default `MaxNdim` of 16 
+    covers the dimensions in which the rule is practical. Raising it 
+    increases the memory of every stored region.
+*/
+template <typename CodomainTypeParam, std::size_t MaxNdim = 16>
+    requires (MaxNdim >= 2 && MaxNdim <= 63)
+        && (std::floating_point<CodomainTypeParam>
+        || (FloatingPointVectorOperable<CodomainTypeParam>
+            && ArrayLike<CodomainTypeParam>))
+struct DynamicGenzMalikD7
+{
+    using DomainType = std::span<const double>;
+    using CodomainType = CodomainTypeParam;
+    using ReturnType = std::pair<IntegralResult<CodomainType>, std::size_t>;
+    using Limits = DynamicBox<MaxNdim>;
+    using RegionType = DynamicSubdivisibleBox<MaxNdim>;
+
+    static constexpr std::size_t max_specialized_ndim = 6;
+
+    [[nodiscard]] static constexpr std::size_t
+    points_count(const Limits& limits) noexcept
+    {
+        return GenzMalikCoefficients::points_count(limits.ndim());
+    }
+
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(FuncType f, const Limits& limits)
+    {
+        return dispatch<2>(f, limits);
+    }
+
+private:
+    static constexpr double gm_point_0 = GenzMalikCoefficients::point_0;
+    static constexpr double gm_point_1 = GenzMalikCoefficients::point_1;
+    static constexpr double gm_point_2 = GenzMalikCoefficients::point_2;
+
+    template <std::size_t Extent, typename FuncType>
+    [[nodiscard]] static constexpr ReturnType
+    dispatch(FuncType f, const Limits& limits)
+    {
+        if constexpr (Extent <= std::min(max_specialized_ndim, MaxNdim))
+        {
+            if (limits.ndim() == Extent)
+                return integrate_extent<Extent>(f, limits);
+            return dispatch<Extent + 1>(f, limits);
+        }
+        else
+            return integrate_extent<std::dynamic_extent>(f, limits);
+    }
+
+    /*
+        Rule in `limits.ndim()` dimensions. If `Extent` is not 
+        `std::dynamic_extent`, it equals `limits.ndim()`.
+    */
+    template <std::size_t Extent, typename FuncType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate_extent(FuncType f, const Limits& limits)
+    {
+        const std::size_t ndim
+            = (Extent == std::dynamic_extent) ? limits.ndim() : Extent;
+        const std::span<const double, Extent> xmin(limits.xmin().data(), ndim);
+        const std::span<const double, Extent> xmax(limits.xmax().data(), ndim);
+
+        std::array<double, MaxNdim> center_buffer;
+        std::array<double, MaxNdim> half_lengths_buffer;
+        std::array<double, MaxNdim> point_buffer;
+        std::array<CodomainType, MaxNdim> second_diff_2_buffer;
+        std::array<CodomainType, MaxNdim> second_diff_3_buffer;
+        std::span<double, Extent> center(center_buffer.data(), ndim);
+        std::span<double, Extent> half_lengths(half_lengths_buffer.data(), ndim);
+        std::span<double, Extent> point(point_buffer.data(), ndim);
+        std::span<CodomainType, Extent> second_diff_2(
+                second_diff_2_buffer.data(), ndim);
+        std::span<CodomainType, Extent> second_diff_3(
+                second_diff_3_buffer.data(), ndim);
+
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            center[i] = 0.5*(xmax[i] + xmin[i]);
+            half_lengths[i] = 0.5*(xmax[i] - xmin[i]);
+            point[i] = center[i];
+        }
+
+        const DomainType x(point);
+        const CodomainType central_value = f(x);
+
+        // symmetric sums over one variable at two distances from the center
+        std::array<CodomainType, 2> gm_sums_1_var{};
+        const std::array<double, 2> gm_points_1_var = {gm_point_0, gm_point_1};
+        const std::array<std::span<CodomainType, Extent>, 2> second_diffs = {
+            second_diff_2, second_diff_3
+        };
+        for (std::size_t k = 0; k < 2; ++k)
+        {
+            for (std::size_t i = 0; i < ndim; ++i)
+            {
+                const double disp = gm_points_1_var[k]*half_lengths[i];
+
+                point[i] = center[i] + disp;
+                const CodomainType fval_plus = f(x);
+
+                point[i] = center[i] - disp;
+                const CodomainType fval_minus = f(x);
+
+                gm_sums_1_var[k] += fval_plus;
+                gm_sums_1_var[k] += fval_minus;
+                second_diffs[k][i] = (-2.0)*central_value;
+                second_diffs[k][i] += fval_plus;
+                second_diffs[k][i] += fval_minus;
+
+                point[i] = center[i];
+            }
+        }
+
+        CodomainType gm_sum_4{};
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            const double disp1 = gm_point_1*half_lengths[i];
+            for (const double sign1 : {1.0, -1.0})
+            {
+                point[i] = center[i] + sign1*disp1;
+                for (std::size_t j = i + 1; j < ndim; ++j)
+                {
+                    const double disp2 = gm_point_1*half_lengths[j];
+
+                    point[j] = center[j] + disp2;
+                    gm_sum_4 += f(x);
+
+                    point[j] = center[j] - disp2;
+                    gm_sum_4 += f(x);
+
+                    point[j] = center[j];
+                }
+            }
+            point[i] = center[i];
+        }
+
+        for (std::size_t i = 0; i < ndim; ++i)
+            point[i] = center[i] + gm_point_2*half_lengths[i];
+
+        CodomainType gm_sum_5 = f(x);
+        std::uint64_t gray = 0;
+        for (std::uint64_t i = 1; i < (std::uint64_t(1) << ndim); ++i)
+        {
+            const std::size_t dim = std::size_t(std::countr_zero(i));
+            const std::uint64_t flipped_bit = std::uint64_t(1) << dim;
+            gray ^= flipped_bit;
+            point[dim] = (gray & flipped_bit) ?
+                    center[dim] - gm_point_2*half_lengths[dim]
+                    : center[dim] + gm_point_2*half_lengths[dim];
+
+            gm_sum_5 += f(x);
+        }
+
+        const double volume = limits.volume();
+        const std::array<CodomainType, 5> gm_sums = {
+            central_value, gm_sums_1_var[0], gm_sums_1_var[1], gm_sum_4,
+            gm_sum_5
+        };
+        const CodomainType val = weighted_sum(
+                volume, GenzMalikCoefficients::weights_d7(ndim), gm_sums);
+        const CodomainType test_val = weighted_sum(
+                volume, GenzMalikCoefficients::weights_d5(ndim), gm_sums);
+
+        CodomainType err = val - test_val;
+        if constexpr (std::is_floating_point<CodomainType>::value)
+            err = std::fabs(err);
+        else
+            std::ranges::transform(
+                    err, err.begin(), static_cast<double(*)(double)>(std::fabs));
+
+        constexpr double ratio = GenzMalikCoefficients::fourth_difference_ratio;
+        std::size_t subdiv_axis = 0;
+        double max_fourth_diff = -1.0;
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            const double fourth_diff
+                = l1_norm(second_diff_2[i] + ratio*second_diff_3[i]);
+            if (fourth_diff > max_fourth_diff)
+            {
+                max_fourth_diff = fourth_diff;
+                subdiv_axis = i;
+            }
+        }
+
+        return {IntegralResult<CodomainType>{val, err}, subdiv_axis};
+    }
+};
+
+}
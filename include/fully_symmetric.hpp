@@ -0,0 +1,713 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "genz_malik.hpp"
+
+namespace cubage
+{
+
+/*
+    Orbit of points under the symmetry group of the hypercube. The points of
+    the orbit have `size` nonzero coordinates, which take the values of the 
+    generators in any order and with any signs. In a uniform orbit all nonzero
+    coordinates are equal to `generators[0]`. Otherwise the orbit has at most 
+    three nonzero coordinates, whose generators are in ascending order.
+*/
+struct SymmetricOrbit
+{
+    std::size_t size;
+    std::array<double, 3> generators;
+    bool uniform;
+
+    constexpr bool operator==(const SymmetricOrbit&) const = default;
+};
+
+/*
+    Generators of the fully symmetric rules of degree 9 and 11.
+
+    A fully symmetric rule of degree 2K + 1 has to integrate the even 
+    monomials of degree <= 2K exactly, which are indexed by partitions of 
+    k <= K into at most n parts. For each number q of nonzero coordinates, 
+    the rule has a uniform orbit with q nonzero coordinates for each degree 
+    k, whose generators are `uniform_generators()[q - 1]`, and the remaining
+    partitions into q parts are matched by the first orbits of size q in 
+    `mixed_orbits()`. The single partition into K parts is matched by the
+    vertex orbit `vertex_generator()`, which has n nonzero coordinates. The
+    weights solving the moment equations are computed at compile time.
+
+    The embedded rule of degree 2K - 1 used for the error estimate is 
+    constructed the same way from a prefix of the generators, without the
+    vertex orbit, so that it reuses the points of the rule.
+
+    The generators have been chosen to keep all points in the interior of the
+    hypercube, and the sum of the absolute values of the weights small, for 
+    dimensions up to ~8.
+*/
+template <std::size_t Degree> struct FullySymmetricGenerators {};
+
+template <>
+struct FullySymmetricGenerators<9>
+{
+    static constexpr std::size_t degree = 9;
+
+    [[nodiscard]] static constexpr std::array<std::array<double, 4>, 3>
+    uniform_generators() noexcept
+    {
+        return {
+            std::array<double, 4>{0.95, 0.75, 0.6, 0.25},
+            std::array<double, 4>{0.8, 0.55, 0.95, 0.0},
+            std::array<double, 4>{0.8, 0.95, 0.0, 0.0}
+        };
+    }
+
+    [[nodiscard]] static constexpr std::array<SymmetricOrbit, 1>
+    mixed_orbits() noexcept
+    {
+        return {
+            SymmetricOrbit{2, {0.6, 0.9, 0.0}, false}
+        };
+    }
+
+    [[nodiscard]] static constexpr double vertex_generator() noexcept
+    {
+        return 0.7;
+    }
+};
+
+template <>
+struct FullySymmetricGenerators<11>
+{
+    static constexpr std::size_t degree = 11;
+
+    [[nodiscard]] static constexpr std::array<std::array<double, 5>, 4>
+    uniform_generators() noexcept
+    {
+        return {
+            std::array<double, 5>{0.85, 0.95, 0.2, 0.65, 0.35},
+            std::array<double, 5>{0.8, 0.9, 0.3, 0.7, 0.0},
+            std::array<double, 5>{0.7, 0.95, 0.8, 0.0, 0.0},
+            std::array<double, 5>{0.9, 0.75, 0.0, 0.0, 0.0}
+        };
+    }
+
+    [[nodiscard]] static constexpr std::array<SymmetricOrbit, 3>
+    mixed_orbits() noexcept
+    {
+        return {
+            SymmetricOrbit{2, {0.6, 0.95, 0.0}, false},
+            SymmetricOrbit{2, {0.4, 0.8, 0.0}, false},
+            SymmetricOrbit{3, {0.65, 0.65, 0.9}, false}
+        };
+    }
+
+    [[nodiscard]] static constexpr double vertex_generator() noexcept
+    {
+        return 0.9;
+    }
+};
+
+// Upper bound for the number of orbits of the rules above.
+inline constexpr std::size_t max_symmetric_orbits = 24;
+
+/*
+    Even monomial x_1^(2 parts[0]) x_2^(2 parts[1])... of a fully symmetric 
+    moment equation.
+*/
+struct EvenMonomial
+{
+    std::size_t size;
+    std::array<std::size_t, max_symmetric_orbits> parts;
+};
+
+template <typename T>
+struct SymmetricRuleList
+{
+    std::array<T, max_symmetric_orbits> items;
+    std::size_t count;
+
+    constexpr void push_back(const T& item) noexcept
+    {
+        items[count++] = item;
+    }
+};
+
+[[nodiscard]] constexpr std::size_t
+partition_count(std::size_t max_sum, std::size_t parts, std::size_t max_part)
+{
+    if (parts == 0) return 1;
+    std::size_t res = 0;
+    for (std::size_t part = 1; part <= std::min(max_part, max_sum); ++part)
+        res += partition_count(max_sum - part, parts - 1, part);
+    return res;
+}
+
+constexpr void append_partitions(
+    SymmetricRuleList<EvenMonomial>& monomials, EvenMonomial& monomial, 
+    std::size_t max_sum, std::size_t max_size, std::size_t max_part)
+{
+    monomials.push_back(monomial);
+    if (monomial.size == max_size) return;
+    for (std::size_t part = 1; part <= std::min(max_part, max_sum); ++part)
+    {
+        monomial.parts[monomial.size++] = part;
+        append_partitions(monomials, monomial, max_sum - part, max_size, part);
+        --monomial.size;
+    }
+}
+
+/*
+    Even monomials of degree <= 2 half_degree in `ndim` variables up to 
+    permutations.
+*/
+[[nodiscard]] constexpr SymmetricRuleList<EvenMonomial>
+symmetric_monomials(std::size_t ndim, std::size_t half_degree)
+{
+    SymmetricRuleList<EvenMonomial> monomials{};
+    EvenMonomial monomial{};
+    append_partitions(
+            monomials, monomial, half_degree, std::min(ndim, half_degree), 
+            half_degree);
+    return monomials;
+}
+
+template <std::size_t Degree>
+[[nodiscard]] constexpr SymmetricRuleList<SymmetricOrbit>
+symmetric_orbits(std::size_t ndim, std::size_t half_degree, bool vertices)
+{
+    using Generators = FullySymmetricGenerators<Degree>;
+    constexpr auto uniform_generators = Generators::uniform_generators();
+    constexpr auto mixed_orbits = Generators::mixed_orbits();
+
+    SymmetricRuleList<SymmetricOrbit> orbits{};
+    orbits.push_back(SymmetricOrbit{0, {}, true});
+    for (std::size_t q = 1; q <= std::min(ndim, half_degree); ++q)
+    {
+        if (q == half_degree && vertices)
+        {
+            orbits.push_back(
+                    SymmetricOrbit{ndim, {Generators::vertex_generator()}, true});
+            continue;
+        }
+
+        const std::size_t uniform_count = half_degree - q + 1;
+        for (std::size_t i = 0; i < uniform_count; ++i)
+            orbits.push_back(
+                    SymmetricOrbit{q, {uniform_generators[q - 1][i]}, true});
+
+        std::size_t mixed_count
+                = partition_count(half_degree, q, half_degree) - uniform_count;
+        for (const auto& orbit : mixed_orbits)
+        {
+            if (mixed_count == 0) break;
+            if (orbit.size != q) continue;
+            orbits.push_back(orbit);
+            --mixed_count;
+        }
+    }
+    return orbits;
+}
+
+[[nodiscard]] constexpr double
+orbit_moment(const EvenMonomial& monomial, const SymmetricOrbit& orbit, std::size_t ndim)
+{
+    const std::size_t q = monomial.size;
+    const std::size_t m = orbit.size;
+    if (q > m) return 0.0;
+
+    double count = double(std::uint64_t(1) << m);
+    for (std::size_t i = q; i < m; ++i)
+        count *= double(ndim - i);
+
+    if (orbit.uniform)
+    {
+        for (std::size_t i = q; i < m; ++i)
+            count /= double(i - q + 1);
+        double res = count;
+        for (std::size_t i = 0; i < q; ++i)
+            for (std::size_t j = 0; j < monomial.parts[i]; ++j)
+                res *= orbit.generators[0]*orbit.generators[0];
+        return res;
+    }
+
+    for (std::size_t i = 0, run = 1; i < m; ++i)
+    {
+        run = (i > 0 && orbit.generators[i] == orbit.generators[i - 1]) ?
+                run + 1 : 1;
+        count /= double(run);
+    }
+
+    // Sum over injective assignments of the monomial variables to generators.
+    double sum = 0.0;
+    std::size_t assignment_count = 1;
+    for (std::size_t i = 0; i < q; ++i)
+        assignment_count *= m;
+    for (std::size_t assignment = 0; assignment < assignment_count; ++assignment)
+    {
+        std::array<bool, 3> used{};
+        double term = 1.0;
+        std::size_t digits = assignment;
+        for (std::size_t i = 0; i < q; ++i, digits /= m)
+        {
+            const std::size_t j = digits % m;
+            if (used[j])
+            {
+                term = 0.0;
+                break;
+            }
+            used[j] = true;
+            for (std::size_t k = 0; k < monomial.parts[i]; ++k)
+                term *= orbit.generators[j]*orbit.generators[j];
+        }
+        sum += term;
+    }
+    return count*sum;
+}
+
+/*
+    Normalized weights of the fully symmetric rule with the given orbits, 
+    which has unit volume weights. Throws `std::invalid_argument`, i.e., 
+    fails to compile when evaluated at compile time, if the moment equations 
+    are numerically singular for the generators.
+*/
+[[nodiscard]] constexpr std::array<double, max_symmetric_orbits>
+symmetric_weights(
+    const SymmetricRuleList<SymmetricOrbit>& orbits, std::size_t ndim, 
+    std::size_t half_degree)
+{
+    const SymmetricRuleList<EvenMonomial> monomials
+            = symmetric_monomials(ndim, half_degree);
+    const std::size_t n = orbits.count;
+
+    std::array<std::array<double, max_symmetric_orbits + 1>, max_symmetric_orbits> 
+    system{};
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const EvenMonomial& monomial = monomials.items[i];
+        for (std::size_t j = 0; j < n; ++j)
+            system[i][j] = orbit_moment(monomial, orbits.items[j], ndim);
+
+        double average = 1.0;
+        for (std::size_t j = 0; j < monomial.size; ++j)
+            average /= double(2*monomial.parts[j] + 1);
+        system[i][n] = average;
+    }
+
+    // A pivot this much smaller than the largest moment of its orbit means 
+    // that the orbits are nearly linearly dependent. The smallest ratio for 
+    // the generators above is ~1e-5.
+    constexpr double min_pivot_ratio = 1.0e-10;
+    std::array<double, max_symmetric_orbits> column_scales{};
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j)
+            column_scales[j] = std::max(column_scales[j], std::fabs(system[i][j]));
+
+    // Gaussian elimination with partial pivoting
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        std::size_t pivot = i;
+        for (std::size_t j = i + 1; j < n; ++j)
+            if (std::fabs(system[j][i]) > std::fabs(system[pivot][i]))
+                pivot = j;
+        std::swap(system[i], system[pivot]);
+        if (!(std::fabs(system[i][i]) > min_pivot_ratio*column_scales[i]))
+            throw std::invalid_argument(
+                    "symmetric_weights: singular moment equations");
+
+        for (std::size_t j = i + 1; j < n; ++j)
+        {
+            const double factor = system[j][i]/system[i][i];
+            for (std::size_t k = i; k <= n; ++k)
+                system[j][k] -= factor*system[i][k];
+        }
+    }
+
+    std::array<double, max_symmetric_orbits> weights{};
+    for (std::size_t i = n; i-- > 0;)
+    {
+        double rhs = system[i][n];
+        for (std::size_t j = i + 1; j < n; ++j)
+            rhs -= system[i][j]*weights[j];
+        weights[i] = rhs/system[i][i];
+    }
+    return weights;
+}
+
+/*
+    Largest relative error of the fully symmetric rule with the given orbits 
+    and weights in the moment equations of degree <= 2 half_degree.
+*/
+[[nodiscard]] constexpr double
+symmetric_moment_residual(
+    const SymmetricRuleList<SymmetricOrbit>& orbits, 
+    std::span<const double> weights, std::size_t ndim, std::size_t half_degree)
+{
+    const SymmetricRuleList<EvenMonomial> monomials
+            = symmetric_monomials(ndim, half_degree);
+
+    double res = 0.0;
+    for (std::size_t i = 0; i < monomials.count; ++i)
+    {
+        const EvenMonomial& monomial = monomials.items[i];
+        double average = 1.0;
+        for (std::size_t j = 0; j < monomial.size; ++j)
+            average /= double(2*monomial.parts[j] + 1);
+
+        double moment = 0.0;
+        for (std::size_t j = 0; j < orbits.count; ++j)
+            moment += weights[j]*orbit_moment(monomial, orbits.items[j], ndim);
+        res = std::max(res, std::fabs(moment - average)/average);
+    }
+    return res;
+}
+
+/*
+    Fully symmetric rule of degree 9 or 11 for hyperrectangular regions, 
+    constructed from the generators in `FullySymmetricGenerators<Degree>` 
+    following
+
+        A. C. Genz, A. A. Malik, "An imbedded family of fully symmetric 
+        numerical integration rules", SIAM J. Numer. Anal. 20:580-588, 1983
+
+    The rule has the same interface as `GenzMalikD7`. The error is estimated 
+    by comparing with an embedded rule of degree two lower, and the suggested
+    subdivision axis is the axis with the largest fourth difference, which 
+    is computed from the two orbits with a single nonzero coordinate closest 
+    to the center.
+
+    The number of points grows as 2^n due to the vertex orbit, and as n^4 
+    (degree 9) or n^5 (degree 11) otherwise. The higher degree pays off for
+    smooth integrands in low dimensions, where the rule needs fewer 
+    evaluations per correct digit than `GenzMalikD7`.
+
+    The weights alternate in sign, and the sum of their absolute values, 
+    which bounds the amplification of rounding errors in the function 
+    values, grows with the dimension. The rules are therefore limited to at
+    most 17 (degree 9) and 8 (degree 11) dimensions, where this sum stays 
+    below 1000 times the volume.
+*/
+template <
+    GenzMalikIntegrable DomainTypeParam, typename CodomainTypeParam,
+    std::size_t Degree>
+    requires (Degree == 9 || Degree == 11)
+        && (std::floating_point<CodomainTypeParam>
+            || (FloatingPointVectorOperable<CodomainTypeParam>
+                && ArrayLike<CodomainTypeParam>))
+struct FullySymmetricRule
+{
+    using DomainType = DomainTypeParam;
+    using CodomainType = CodomainTypeParam;
+    using ReturnType = std::pair<IntegralResult<CodomainType>, std::size_t>;
+    using Limits = Box<DomainType>;
+    using RegionType = SubdivisibleBox<DomainType>;
+
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(FuncType f, const Limits& limits)
+    {
+        const DomainType center = limits.center();
+        const DomainType half_lengths
+            = DomainValueType(0.5)*limits.side_lengths();
+
+        std::array<CodomainType, orbit_count> sums;
+        sums[0] = f(center);
+
+        const auto& [sum_1, second_diff_1] = symmetric_sum_1_var(
+                f, center, half_lengths, sums[0], orbits[1].generators[0]);
+        const auto& [sum_2, second_diff_2] = symmetric_sum_1_var(
+                f, center, half_lengths, sums[0], orbits[2].generators[0]);
+        sums[1] = sum_1;
+        sums[2] = sum_2;
+
+        for (std::size_t i = 3; i < orbit_count; ++i)
+            sums[i] = orbit_sum(f, center, half_lengths, orbits[i]);
+
+        return rule_result(limits.volume(), sums, second_diff_1, second_diff_2);
+    }
+
+    [[nodiscard]] static constexpr std::size_t points_count() noexcept
+    {
+        std::size_t res = 0;
+        for (const auto& orbit : orbits)
+            res += orbit_points_count(orbit);
+        return res;
+    }
+
+private:
+    static constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
+    static constexpr std::size_t half_degree = (Degree - 1)/2;
+
+    // The evaluation points are computed in the precision of the domain, 
+    // as in `GenzMalikD7`.
+    using DomainValueType = typename DomainType::value_type;
+
+    static constexpr SymmetricRuleList<SymmetricOrbit> orbit_list
+            = symmetric_orbits<Degree>(ndim, half_degree, true);
+    static constexpr std::size_t orbit_count = orbit_list.count;
+
+    static_assert(orbit_list.items[1].size == 1 && orbit_list.items[2].size == 1);
+
+    static constexpr std::array<SymmetricOrbit, orbit_count> orbits
+            = []()
+            {
+                std::array<SymmetricOrbit, orbit_count> res{};
+                std::copy_n(orbit_list.items.begin(), orbit_count, res.begin());
+                return res;
+            }();
+
+    static constexpr std::array<double, orbit_count> weights
+            = []()
+            {
+                const auto solution
+                        = symmetric_weights(orbit_list, ndim, half_degree);
+                std::array<double, orbit_count> res{};
+                std::copy_n(solution.begin(), orbit_count, res.begin());
+                return res;
+            }();
+
+    // Weights of the embedded rule of degree two lower. The orbits of the 
+    // embedded rule are a subset of the orbits of the rule.
+    static constexpr std::array<double, orbit_count> embedded_weights
+            = []()
+            {
+                const auto embedded_orbits = symmetric_orbits<Degree>(
+                        ndim, half_degree - 1, false);
+                const auto solution = symmetric_weights(
+                        embedded_orbits, ndim, half_degree - 1);
+                std::array<double, orbit_count> res{};
+                for (std::size_t i = 0; i < embedded_orbits.count; ++i)
+                {
+                    const auto it = std::ranges::find(
+                            orbits, embedded_orbits.items[i]);
+                    res[std::size_t(std::distance(orbits.begin(), it))]
+                            = solution[i];
+                }
+                return res;
+            }();
+
+    using DiffType = std::array<CodomainType, ndim>;
+    using NormedDiffType = std::array<double, ndim>;
+
+    [[nodiscard]] static constexpr std::size_t
+    orbit_points_count(const SymmetricOrbit& orbit) noexcept
+    {
+        std::size_t res = std::size_t(1) << orbit.size;
+        for (std::size_t i = 0; i < orbit.size; ++i)
+            res = (res*(ndim - i))/(orbit.uniform ? i + 1 : 1);
+        if (!orbit.uniform)
+        {
+            for (std::size_t i = 1, run = 1; i < orbit.size; ++i)
+            {
+                run = (orbit.generators[i] == orbit.generators[i - 1]) ?
+                        run + 1 : 1;
+                res /= run;
+            }
+        }
+        return res;
+    }
+
+    [[nodiscard]] static constexpr double absolute_weight_sum(
+        const std::array<double, orbit_count>& orbit_weights) noexcept
+    {
+        double res = 0.0;
+        for (std::size_t i = 0; i < orbit_count; ++i)
+            res += double(orbit_points_count(orbits[i]))
+                *std::fabs(orbit_weights[i]);
+        return res;
+    }
+
+    static constexpr double max_absolute_weight_sum = 1000.0;
+    static_assert(absolute_weight_sum(weights) <= max_absolute_weight_sum
+            && absolute_weight_sum(embedded_weights) <= max_absolute_weight_sum,
+            "the fully symmetric rule is ill-conditioned in this dimension");
+
+    // The embedded rule has zero weights for the other orbits, so both 
+    // rules are checked against the orbits of the rule.
+    static_assert(
+            symmetric_moment_residual(
+                    orbit_list, weights, ndim, half_degree) < 1.0e-12
+            && symmetric_moment_residual(
+                    orbit_list, embedded_weights, ndim, half_degree - 1) < 1.0e-12,
+            "the fully symmetric rule is not exact in this dimension");
+
+    [[nodiscard]] static constexpr ReturnType rule_result(
+        double volume, const std::array<CodomainType, orbit_count>& sums,
+        const DiffType& second_diff_1, const DiffType& second_diff_2) noexcept
+    {
+        const CodomainType val = weighted_sum(volume, weights, sums);
+        const CodomainType test_val = weighted_sum(volume, embedded_weights, sums);
+
+        CodomainType err = val - test_val;
+        if constexpr (std::is_floating_point<CodomainType>::value)
+            err = std::fabs(err);
+        else
+            std::ranges::transform(
+                    err, err.begin(), static_cast<double(*)(double)>(std::fabs));
+
+        // The second differences are l^2 h^2 f'' + l^4 h^4 f''''/12 + ..., 
+        // so the second derivative cancels in this combination.
+        constexpr double ratio
+                = (orbits[1].generators[0]*orbits[1].generators[0])
+                /(orbits[2].generators[0]*orbits[2].generators[0]);
+        NormedDiffType fourth_diff_normed;
+        for (std::size_t i = 0; i < ndim; ++i)
+            fourth_diff_normed[i] = l1_norm(
+                    second_diff_1[i] - ratio*second_diff_2[i]);
+
+        return {
+            IntegralResult<CodomainType>{val, err},
+            std::size_t(std::distance(
+                    fourth_diff_normed.begin(),
+                    std::ranges::max_element(fourth_diff_normed)))
+        };
+    }
+
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr std::pair<CodomainType, DiffType> 
+    symmetric_sum_1_var(
+        FuncType f, const DomainType& center, const DomainType& half_lengths, 
+        const CodomainType& central_value, double generator)
+    {
+        CodomainType val{};
+        DomainType point = center;
+
+        DiffType second_differences;
+        second_differences.fill((-2.0)*central_value);
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            const DomainValueType disp
+                = DomainValueType(generator)*half_lengths[i];
+
+            point[i] = center[i] + disp;
+            const CodomainType fval_plus = f(point);
+            val += fval_plus;
+            second_differences[i] += fval_plus;
+            
+            point[i] = center[i] - disp;
+            const CodomainType fval_minus = f(point);
+            val += fval_minus;
+            second_differences[i] += fval_minus;
+
+            point[i] = center[i];
+        }
+
+        return {val, second_differences};
+    }
+
+    // Sum over the points of an orbit. The nonzero coordinates run over the
+    // combinations of axes, the distinct permutations of the generators, and
+    // the signs.
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr CodomainType
+    orbit_sum(
+        FuncType f, const DomainType& center, const DomainType& half_lengths,
+        const SymmetricOrbit& orbit)
+    {
+        const std::size_t size = orbit.size;
+        const std::uint64_t sign_count = std::uint64_t(1) << size;
+
+        std::array<std::size_t, ndim> axes{};
+        std::array<double, ndim> generators{};
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            axes[i] = i;
+            generators[i] = orbit.generators[orbit.uniform ? 0 : i];
+        }
+
+        CodomainType val{};
+        DomainType point = center;
+        do
+        {
+            // `std::next_permutation` restores the ascending order when it
+            // returns false.
+            do
+            {
+                for (std::uint64_t signs = 0; signs < sign_count; ++signs)
+                {
+                    for (std::size_t i = 0; i < size; ++i)
+                    {
+                        const DomainValueType disp = DomainValueType(generators[i])
+                            *half_lengths[axes[i]];
+                        point[axes[i]] = (signs & (std::uint64_t(1) << i)) ?
+                                center[axes[i]] - disp : center[axes[i]] + disp;
+                    }
+                    val += f(point);
+                }
+            }
+            while (!orbit.uniform && std::next_permutation(
+                    generators.begin(), generators.begin() + size));
+
+            for (std::size_t i = 0; i < size; ++i)
+                point[axes[i]] = center[axes[i]];
+        }
+        while (next_combination(axes, size));
+
+        return val;
+    }
+
+    static constexpr bool
+    next_combination(std::array<std::size_t, ndim>& axes, std::size_t size) noexcept
+    {
+        for (std::size_t i = size; i-- > 0;)
+        {
+            if (axes[i] < ndim - size + i)
+            {
+                ++axes[i];
+                for (std::size_t j = i + 1; j < size; ++j)
+                    axes[j] = axes[j - 1] + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+template <typename DomainType, typename CodomainType, std::size_t Degree>
+struct HypercubeRuleSelector
+{
+    using type = FullySymmetricRule<DomainType, CodomainType, Degree>;
+};
+
+template <typename DomainType, typename CodomainType>
+struct HypercubeRuleSelector<DomainType, CodomainType, 7>
+{
+    using type = GenzMalikD7<DomainType, CodomainType>;
+};
+
+/*
+    Rule of the given degree for hyperrectangular regions: `GenzMalikD7` for
+    degree 7 and `FullySymmetricRule` for degrees 9 and 11.
+*/
+template <typename DomainType, typename CodomainType, std::size_t Degree>
+using HypercubeRule
+        = typename HypercubeRuleSelector<DomainType, CodomainType, Degree>::type;
+
+}
\ No newline at end of file
@@ -22,8 +22,15 @@ SOFTWARE.
 #pragma once
 
 #include <cmath>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <span>
+#include <bit>
+#include <cstdint>
 
 #include "box_region.hpp"
+#include "thread_pool.hpp"
 
 namespace cubage
 {
@@ -35,6 +42,11 @@ template <typename FieldType>
         return std::fabs(x);
     else
     {
+        if constexpr (simd::Dispatched<FieldType>)
+        {
+            if (!std::is_constant_evaluated())
+                return simd::kernels().abs_sum(x.data(), x.size());
+        }
         using value_type = typename FieldType::value_type;
         auto v = x | std::views::transform(
                 static_cast<double(*)(double)>(std::fabs));
@@ -46,9 +58,76 @@ template <typename FieldType>
 concept GenzMalikIntegrable
     = ArrayLike<FieldType>
     && std::tuple_size<FieldType>::value > 1
-    && std::tuple_size<FieldType>::value <= 32
+    && std::tuple_size<FieldType>::value <= 63
     && FloatingPointVectorOperable<FieldType>;
 
+/*
+    Generators and weights of the degree 7 Genz-Malik rule in `ndim` 
+    dimensions, and of its embedded rule of degree 5. The weights are ordered 
+    by point set: the center, the two one-variable sets, the two-variable set
+    and the vertices.
+*/
+struct GenzMalikCoefficients
+{
+    static constexpr double point_0
+        = 0.358568582800318091990645153907937495454;
+    static constexpr double point_1
+        = 0.948683298050513799599668063329815560116;
+    static constexpr double point_2
+        = 0.6882472016116852977216287342936235251269;
+
+    // Ratio of the second differences at `point_1` and `point_0`, which 
+    // cancels the second derivative in their combination.
+    static constexpr double fourth_difference_ratio = 1.0/7.0;
+
+    [[nodiscard]] static constexpr std::size_t
+    points_count(std::size_t ndim) noexcept
+    {
+        return (std::size_t(1) << ndim) + 1 + 2*ndim*(1 + ndim);
+    }
+
+    [[nodiscard]] static constexpr std::array<double, 5>
+    weights_d7(std::size_t ndim) noexcept
+    {
+        const double n = double(ndim);
+        return {
+            ((400.0/19683.0)*n + (-9120.0/19683.0))*n + (12824.0/19683.0),
+            980.0/6561.0,
+            (-400.0/19683.0)*n + (1820.0/19683.0),
+            200.0/19683.0,
+            (6859.0/19683.0)/double(std::uint64_t(1) << ndim)
+        };
+    }
+
+    [[nodiscard]] static constexpr std::array<double, 4>
+    weights_d5(std::size_t ndim) noexcept
+    {
+        const double n = double(ndim);
+        return {
+            ((50.0/729.0)*n + (-950.0/729.0))*n + 1.0,
+            245.0/486.0,
+            (-100.0/1458.0)*n + (265.0/1458.0),
+            25.0/729.0
+        };
+    }
+};
+
+/*
+    Error estimate of `GenzMalikD7` from the difference to the embedded rule 
+    of degree 5.
+*/
+struct EmbeddedRuleError {};
+
+/*
+    Error estimate of `GenzMalikD7` from a sequence of null rules on the same
+    points, following Berntsen, Espelid and Genz. The null rules of degree 5,
+    3 and 1 measure how fast the higher order terms of the integrand decay in
+    the region. When they decay fast, the error estimate is scaled down 
+    accordingly, which is less pessimistic than the difference of two rules 
+    for smooth integrands.
+*/
+struct NullRuleError {};
+
 /*
     Genz-Malik rule of degree 7 based on 
 
@@ -66,14 +145,27 @@ concept GenzMalikIntegrable
     returns a suggestion for a subdivision axis. This axis is the axis with the 
     largest fourth difference as described in the second reference.
 
-    The dimensionality of the domain of integration is limited to <= 32. If you 
-    need to integrate over a 33 dimensional region, you should probably be 
-    using Monte-Carlo.
+    The number of evaluation points grows as 2^n with the dimension n, due to
+    the vertices of the hypercube. The dimensionality of the domain of 
+    integration is limited to <= 63, so that the vertices can be enumerated 
+    with a 64-bit Gray code. In practice, adaptive integration needs many 
+    regions, which limits it to about 20 dimensions, and beyond ~30 
+    dimensions even a single application of the rule is prohibitively 
+    expensive. From 16 dimensions on, a `MultiIntegrator` with several 
+    threads evaluates the sum over the vertices in parallel with the 
+    `ThreadPool` overload of `integrate`.
+
+    The error estimate is selected by `ErrorEstimateType`, which is either 
+    `EmbeddedRuleError` or `NullRuleError`. Both reuse the points of the rule.
 */
-template <GenzMalikIntegrable DomainTypeParam, typename CodomainTypeParam>
-    requires std::floating_point<CodomainTypeParam>
+template <
+    GenzMalikIntegrable DomainTypeParam, typename CodomainTypeParam,
+    typename ErrorEstimateType = EmbeddedRuleError>
+    requires (std::same_as<ErrorEstimateType, EmbeddedRuleError>
+            || std::same_as<ErrorEstimateType, NullRuleError>)
+        && (std::floating_point<CodomainTypeParam>
         || (FloatingPointVectorOperable<CodomainTypeParam>
-            && ArrayLike<CodomainTypeParam>)
+            && ArrayLike<CodomainTypeParam>))
 struct GenzMalikD7
 {
     using DomainType = DomainTypeParam;
@@ -84,66 +176,250 @@ struct GenzMalikD7
 
     template <typename FuncType>
         requires MapsAs<FuncType, DomainType, CodomainType>
+            && (!BatchMapsAs<FuncType, DomainType, CodomainType>)
     [[nodiscard]] static constexpr ReturnType
-    integrate(FuncType f, const Limits& limits) noexcept
+    integrate(FuncType f, const Limits& limits)
     {
-        constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
-        constexpr double v = double(1UL << ndim);
-        constexpr std::array<double, 5> gm_weights_d7 = {
-            ((400.0/19683.0)*double(ndim) + (-9120.0/19683.0))*double(ndim) + (12824.0/19683.0),
-            980.0/6561.0,
-            (-400.0/19683.0)*double(ndim) + (1820.0/19683.0),
-            200.0/19683.0,
-            (6859.0/19683.0)/v
-        };
-
-        constexpr std::array<double, 4> gm_weights_d5 = {
-            ((50.0/729.0)*double(ndim) + (-950.0/729.0))*double(ndim) + 1.0,
-            245.0/486.0,
-            (-100.0/1458.0)*double(ndim) + (265.0/1458.0),
-            25.0/729.0
-        };
-
         const DomainType center = limits.center();
-        const DomainType half_lengths = 0.5*limits.side_lengths();
-        const double volume = limits.volume();
+        const DomainType half_lengths
+            = DomainValueType(0.5)*limits.side_lengths();
 
         const CodomainType central_value = f(center);
-        const CodomainType& gm_sum_1 = central_value;
 
-        constexpr double gm_point_0 = 0.358568582800318091990645153907937495454;
-        constexpr double gm_point_1 = 0.948683298050513799599668063329815560116;
         const auto& [gm_sum_2, second_diff_2] = symmetric_sum_1_var(
-                f, center, half_lengths, central_value, gm_point_0);
+                f, center, half_lengths, central_value,
+                DomainValueType(gm_point_0));
         const auto& [gm_sum_3, second_diff_3] = symmetric_sum_1_var(
-                f, center, half_lengths, central_value, gm_point_1);
+                f, center, half_lengths, central_value,
+                DomainValueType(gm_point_1));
         const CodomainType gm_sum_4 = symmetric_sum_2_var(
                 f, center, half_lengths);
         const CodomainType gm_sum_5 = symmetric_sum_n_var(
                 f, center, half_lengths);
 
-        const std::array<double, 5> volume_weights_d7 = {
-            volume*gm_weights_d7[0], volume*gm_weights_d7[1], volume*gm_weights_d7[2], volume*gm_weights_d7[3], volume*gm_weights_d7[4]
-        };
-        const std::array<double, 4> volume_weights_d5 = {
-            volume*gm_weights_d5[0], volume*gm_weights_d5[1], volume*gm_weights_d5[2], volume*gm_weights_d5[3]
+        return rule_result(
+                limits.volume(),
+                {central_value, gm_sum_2, gm_sum_3, gm_sum_4, gm_sum_5},
+                second_diff_2, second_diff_3);
+    }
+
+    /*
+        Variant of the rule, which evaluates the sum over the 2^n vertices of
+        the hypercube in parallel on `pool`. The vertices are split into 
+        chunks by the Gray code prefix of the highest dimensions, and the 
+        partial sums are added in a fixed order, so the result does not 
+        depend on the number of threads. It may differ from the serial rule 
+        by rounding.
+
+        The integrand is called concurrently from multiple threads, and must 
+        therefore be safe to call concurrently.
+    */
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static ReturnType
+    integrate(FuncType f, const Limits& limits, ThreadPool& pool)
+    {
+        const DomainType center = limits.center();
+        const DomainType half_lengths
+            = DomainValueType(0.5)*limits.side_lengths();
+
+        const CodomainType central_value = f(center);
+
+        const auto& [gm_sum_2, second_diff_2] = symmetric_sum_1_var(
+                f, center, half_lengths, central_value,
+                DomainValueType(gm_point_0));
+        const auto& [gm_sum_3, second_diff_3] = symmetric_sum_1_var(
+                f, center, half_lengths, central_value,
+                DomainValueType(gm_point_1));
+        const CodomainType gm_sum_4 = symmetric_sum_2_var(
+                f, center, half_lengths);
+        const CodomainType gm_sum_5 = parallel_symmetric_sum_n_var(
+                f, center, half_lengths, pool);
+
+        return rule_result(
+                limits.volume(),
+                {central_value, gm_sum_2, gm_sum_3, gm_sum_4, gm_sum_5},
+                second_diff_2, second_diff_3);
+    }
+
+    /*
+        Batched variant of the rule. The evaluation points are generated into
+        a buffer of up to `batch_points_count` points, and the integrand is
+        called once per full buffer. In low dimensions all `points_count()`
+        points fit in one buffer, so the integrand is called once. The points
+        are laid out as follows:
+
+            center,
+            center +/- gm_point_0*half_lengths[i]*e_i for each axis i,
+            center +/- gm_point_1*half_lengths[i]*e_i for each axis i,
+            center +/- gm_point_1*half_lengths[i]*e_i
+                +/- gm_point_1*half_lengths[j]*e_j for each pair i < j,
+            the vertices center +/- gm_point_2*half_lengths.
+
+        The buffer lives on the stack and takes at most 32 KiB for the points
+        and values together, so no memory is allocated.
+    */
+    template <typename FuncType>
+        requires BatchMapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(FuncType f, const Limits& limits)
+    {
+        const DomainType center = limits.center();
+        const DomainType half_lengths
+            = DomainValueType(0.5)*limits.side_lengths();
+
+        std::array<DomainType, batch_points_count> points;
+        std::array<CodomainType, batch_points_count> values;
+        static_assert(sizeof(points) + sizeof(values) <= batch_buffer_size,
+                "a point and its value must fit into the batch buffer");
+        std::size_t buffered_count = 0;
+        BatchSums sums{};
+        auto evaluate_buffer = [&]()
+        {
+            f(std::span<const DomainType>(points.data(), buffered_count),
+                    std::span<CodomainType>(values.data(), buffered_count));
+            for (std::size_t i = 0; i < buffered_count; ++i)
+                sums.add(values[i]);
+            buffered_count = 0;
         };
 
-        const CodomainType val
-                = volume_weights_d7[0]*gm_sum_1 + volume_weights_d7[1]*gm_sum_2
-                + volume_weights_d7[2]*gm_sum_3 + volume_weights_d7[3]*gm_sum_4
-                + volume_weights_d7[4]*gm_sum_5;
-        
-        const CodomainType test_val
-                = volume_weights_d5[0]*gm_sum_1 + volume_weights_d5[1]*gm_sum_2
-                + volume_weights_d5[2]*gm_sum_3 + volume_weights_d5[3]*gm_sum_4;
-        
+        generate_points(center, half_lengths, [&](const DomainType& point)
+        {
+            points[buffered_count++] = point;
+            if (buffered_count == batch_points_count)
+                evaluate_buffer();
+        });
+        if (buffered_count > 0)
+            evaluate_buffer();
+
+        return rule_result(
+                limits.volume(),
+                {
+                    sums.central_value, sums.gm_sum_2, sums.gm_sum_3,
+                    sums.gm_sum_4, sums.gm_sum_5
+                },
+                sums.second_diff_2, sums.second_diff_3);
+    }
+
+    [[nodiscard]] static constexpr std::size_t points_count() noexcept
+    {
+        return GenzMalikCoefficients::points_count(ndim);
+    }
+
+private:
+    static constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
+
+    // The evaluation points are computed in the precision of the domain, 
+    // while the weights, sums and error estimates are in that of the 
+    // codomain.
+    using DomainValueType = typename DomainType::value_type;
+    static constexpr std::uint64_t vertex_count = std::uint64_t(1) << ndim;
+
+    // Number of highest dimensions whose signs are fixed within a chunk of
+    // the parallel vertex sum.
+    static constexpr std::size_t chunk_prefix_ndim = std::min<std::size_t>(ndim, 8);
+
+    // Size of the stack buffer of points and values of the batched rule.
+    static constexpr std::size_t batch_buffer_size = std::size_t(1) << 15;
+
+    // Number of points passed to a batched integrand at once, limited so
+    // that the points and their values fit into `batch_buffer_size` bytes.
+    static constexpr std::size_t batch_points_count = std::min<std::size_t>(
+            GenzMalikCoefficients::points_count(ndim),
+            std::max<std::size_t>(
+                1, batch_buffer_size/(sizeof(DomainType) + sizeof(CodomainType))));
+
+    static constexpr double gm_point_0 = GenzMalikCoefficients::point_0;
+    static constexpr double gm_point_1 = GenzMalikCoefficients::point_1;
+    static constexpr double gm_point_2 = GenzMalikCoefficients::point_2;
+
+    static constexpr std::array<double, 5> gm_weights_d7
+        = GenzMalikCoefficients::weights_d7(ndim);
+    static constexpr std::array<double, 4> gm_weights_d5
+        = GenzMalikCoefficients::weights_d5(ndim);
+
+    /*
+        Null rules of degree 5, 3, 3 and 1 on the five orbits of the rule. 
+        They are obtained as differences of the rule and lower degree rules
+        on subsets of the orbits, orthogonalized and scaled to the norm of the
+        rule, where the inner product weights each orbit by its size.
+    */
+    static constexpr std::array<std::array<double, 5>, 4> gm_null_rules
+            = []()
+            {
+                constexpr std::array<double, 5> orbit_sizes = {
+                    1.0, 2.0*double(ndim), 2.0*double(ndim), 
+                    2.0*double(ndim)*double(ndim - 1), double(vertex_count)
+                };
+                auto dot = [&](const std::array<double, 5>& a, const std::array<double, 5>& b)
+                {
+                    double res = 0.0;
+                    for (std::size_t i = 0; i < 5; ++i)
+                        res += orbit_sizes[i]*a[i]*b[i];
+                    return res;
+                };
+
+                // Degree 3 rule on the center and one other orbit, whose 
+                // points have the sum of squares `second_moment` along an 
+                // axis.
+                auto degree_3_rule = [&](std::size_t orbit, double second_moment)
+                {
+                    std::array<double, 5> rule{};
+                    rule[orbit] = (1.0/3.0)/second_moment;
+                    rule[0] = 1.0 - orbit_sizes[orbit]*rule[orbit];
+                    return rule;
+                };
+
+                const std::array<std::array<double, 5>, 4> lower_rules = {
+                    std::array<double, 5>{
+                        gm_weights_d5[0], gm_weights_d5[1], gm_weights_d5[2],
+                        gm_weights_d5[3], 0.0
+                    },
+                    degree_3_rule(1, 2.0*gm_point_0*gm_point_0),
+                    degree_3_rule(2, 2.0*gm_point_1*gm_point_1),
+                    std::array<double, 5>{1.0, 0.0, 0.0, 0.0, 0.0}
+                };
+
+                const double rule_norm = std::sqrt(dot(gm_weights_d7, gm_weights_d7));
+                std::array<std::array<double, 5>, 4> null_rules{};
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    for (std::size_t k = 0; k < 5; ++k)
+                        null_rules[i][k] = gm_weights_d7[k] - lower_rules[i][k];
+                    for (std::size_t j = 0; j < i; ++j)
+                    {
+                        const double projection = dot(null_rules[i], null_rules[j])
+                                /dot(null_rules[j], null_rules[j]);
+                        for (std::size_t k = 0; k < 5; ++k)
+                            null_rules[i][k] -= projection*null_rules[j][k];
+                    }
+                    const double scale = rule_norm/std::sqrt(dot(null_rules[i], null_rules[i]));
+                    for (std::size_t k = 0; k < 5; ++k)
+                        null_rules[i][k] *= scale;
+                }
+                return null_rules;
+            }();
+
+    using DiffType
+            = std::array<CodomainType, std::tuple_size<DomainType>::value>;
+    using NormedDiffType
+            = std::array<double, std::tuple_size<DomainType>::value>;
+
+    [[nodiscard]] static constexpr ReturnType rule_result(
+        double volume, const std::array<CodomainType, 5>& gm_sums,
+        const DiffType& second_diff_2, const DiffType& second_diff_3) noexcept
+    {
+        const CodomainType val = weighted_sum(volume, gm_weights_d7, gm_sums);
+        const CodomainType test_val = weighted_sum(volume, gm_weights_d5, gm_sums);
+
         CodomainType err = val - test_val;
         if constexpr (std::is_floating_point<CodomainType>::value)
             err = std::fabs(err);
         else
             std::ranges::transform(
                     err, err.begin(), static_cast<double(*)(double)>(std::fabs));
+        if constexpr (std::same_as<ErrorEstimateType, NullRuleError>)
+            err = null_rule_error(volume, gm_sums, err);
 
         const std::array<double, ndim> fourth_diff_normed
                 = normed_fourth_difference(second_diff_2, second_diff_3);
@@ -154,17 +430,178 @@ struct GenzMalikD7
         };
     }
 
-    [[nodiscard]] static constexpr std::size_t points_count() noexcept
+    [[nodiscard]] static constexpr CodomainType null_rule_error(
+        double volume, const std::array<CodomainType, 5>& gm_sums,
+        const CodomainType& embedded_err) noexcept
     {
-        constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
-        return (1 << ndim) + 1 + 2*ndim*(1 + ndim);
+        std::array<CodomainType, 4> null_values;
+        for (std::size_t i = 0; i < 4; ++i)
+            null_values[i] = weighted_sum(volume, gm_null_rules[i], gm_sums);
+
+        if constexpr (std::is_floating_point<CodomainType>::value)
+            return null_rule_error(
+                    null_values[0], null_values[1], null_values[2], null_values[3],
+                    embedded_err);
+        else
+        {
+            CodomainType err;
+            for (std::size_t i = 0; i < err.size(); ++i)
+                err[i] = null_rule_error(
+                        null_values[0][i], null_values[1][i], null_values[2][i],
+                        null_values[3][i], embedded_err[i]);
+            return err;
+        }
     }
 
-private:
-    using DiffType
-            = std::array<CodomainType, std::tuple_size<DomainType>::value>;
-    using NormedDiffType
-            = std::array<double, std::tuple_size<DomainType>::value>;
+    /*
+        Combines the values of the null rules of degree 5, 3, 3 and 1 into an
+        error estimate with `null_rule_error_estimate`, where the two null 
+        rules of degree 3 count as one. The lower bound `min_ratio` on the 
+        ratio of consecutive null rules was chosen to keep the estimate 
+        reliable on the Genz test package. It is lower than for `GenzCools`, 
+        since the null rules are orthogonalized and scaled to the norm of the
+        rule, so that their ratios are a more reliable measure of the decay.
+
+        If the null rule of degree 5 vanishes up to rounding compared to the
+        lower degree ones, the integrand is a polynomial of degree at most 5 as
+        far as the rule can tell, which the rule integrates exactly. The lower
+        degree null rules then measure that polynomial rather than the error, 
+        and grow with the dimension along with the norm of the rule, so the 
+        difference to the embedded rule `embedded_err` is used instead.
+    */
+    [[nodiscard]] static constexpr double null_rule_error(
+        double null_5, double null_3a, double null_3b, double null_1,
+        double embedded_err) noexcept
+    {
+        constexpr double min_ratio = 1.0/8.0;
+        constexpr double polynomial_ratio
+            = 64.0*std::numeric_limits<double>::epsilon();
+        const std::array<double, 3> errors = {
+            std::fabs(null_5),
+            std::max(std::fabs(null_3a), std::fabs(null_3b)),
+            std::fabs(null_1)
+        };
+        if (errors[0] <= polynomial_ratio*std::max(errors[1], errors[2]))
+            return embedded_err;
+
+        return null_rule_error_estimate(errors, min_ratio);
+    }
+
+    /*
+        Call `emit` with each evaluation point in the order documented for the
+        batched variant of `integrate`.
+    */
+    template <typename EmitType>
+    static constexpr void generate_points(
+        const DomainType& center, const DomainType& half_lengths,
+        EmitType&& emit) noexcept
+    {
+        emit(center);
+
+        for (const double gm_point : {gm_point_0, gm_point_1})
+        {
+            for (std::size_t i = 0; i < ndim; ++i)
+            {
+                const DomainValueType disp
+                    = DomainValueType(gm_point)*half_lengths[i];
+
+                DomainType point = center;
+                point[i] = center[i] + disp;
+                emit(point);
+
+                point[i] = center[i] - disp;
+                emit(point);
+            }
+        }
+
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            const DomainValueType disp1
+                = DomainValueType(gm_point_1)*half_lengths[i];
+            for (std::size_t j = i + 1; j < ndim; ++j)
+            {
+                const DomainValueType disp2
+                    = DomainValueType(gm_point_1)*half_lengths[j];
+                for (const DomainValueType sign1 : {1.0f, -1.0f})
+                {
+                    for (const DomainValueType sign2 : {1.0f, -1.0f})
+                    {
+                        DomainType point = center;
+                        point[i] = center[i] + sign1*disp1;
+                        point[j] = center[j] + sign2*disp2;
+                        emit(point);
+                    }
+                }
+            }
+        }
+
+        for (std::uint64_t vertex = 0; vertex < vertex_count; ++vertex)
+        {
+            DomainType point = center;
+            for (std::size_t i = 0; i < ndim; ++i)
+            {
+                const DomainValueType disp
+                    = DomainValueType(gm_point_2)*half_lengths[i];
+                point[i] = (vertex & (std::uint64_t(1) << i)) ?
+                        center[i] - disp : center[i] + disp;
+            }
+            emit(point);
+        }
+    }
+
+    [[nodiscard]] static constexpr CodomainType
+    sum(std::span<const CodomainType> values) noexcept
+    {
+        CodomainType val{};
+        for (const auto& value : values)
+            val += value;
+        return val;
+    }
+
+    /*
+        Sums of the rule accumulated from the function values of the batched
+        variant of `integrate`, which are added in the order of the points.
+    */
+    struct BatchSums
+    {
+        CodomainType central_value{};
+        CodomainType gm_sum_2{};
+        CodomainType gm_sum_3{};
+        CodomainType gm_sum_4{};
+        CodomainType gm_sum_5{};
+        DiffType second_diff_2{};
+        DiffType second_diff_3{};
+        std::uint64_t count = 0;
+
+        constexpr void add(const CodomainType& value) noexcept
+        {
+            constexpr std::uint64_t sum_2_end = 1 + 2*ndim;
+            constexpr std::uint64_t sum_3_end = sum_2_end + 2*ndim;
+            constexpr std::uint64_t sum_4_end = sum_3_end + 2*ndim*(ndim - 1);
+
+            const std::uint64_t index = count++;
+            if (index == 0)
+            {
+                central_value = value;
+                second_diff_2.fill((-2.0)*central_value);
+                second_diff_3.fill((-2.0)*central_value);
+            }
+            else if (index < sum_2_end)
+            {
+                gm_sum_2 += value;
+                second_diff_2[(index - 1)/2] += value;
+            }
+            else if (index < sum_3_end)
+            {
+                gm_sum_3 += value;
+                second_diff_3[(index - sum_2_end)/2] += value;
+            }
+            else if (index < sum_4_end)
+                gm_sum_4 += value;
+            else
+                gm_sum_5 += value;
+        }
+    };
 
     [[nodiscard]] static constexpr std::size_t
     subdiv_axis(const NormedDiffType& fourth_diff_normed) noexcept
@@ -178,9 +615,8 @@ private:
     normed_fourth_difference(
         const DiffType& second_diff_2, const DiffType& second_diff_3) noexcept
     {
-        constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
-        constexpr double ratio = (1.0/7.0);
-        
+        constexpr double ratio = GenzMalikCoefficients::fourth_difference_ratio;
+
         NormedDiffType fourth_diff_normed;
         for (size_t i = 0; i < ndim; ++i)
             fourth_diff_normed[i] = l1_norm(
@@ -193,9 +629,8 @@ private:
         requires MapsAs<FuncType, DomainType, CodomainType>
     [[nodiscard]] static constexpr std::pair<CodomainType, DiffType> 
     symmetric_sum_1_var(
-        FuncType f, const DomainType& center, const DomainType& half_lengths, const CodomainType& central_value, double gm_point) noexcept
+        FuncType f, const DomainType& center, const DomainType& half_lengths, const CodomainType& central_value, DomainValueType gm_point)
     {
-        constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
         CodomainType val{};
         DomainType point = center;
 
@@ -203,7 +638,7 @@ private:
         second_differences.fill((-2.0)*central_value);
         for (std::size_t i = 0; i < ndim; ++i)
         {
-            const double disp = gm_point*half_lengths[i];
+            const DomainValueType disp = gm_point*half_lengths[i];
 
             point[i] = center[i] + disp;
             const CodomainType fval_plus = f(point);
@@ -226,21 +661,20 @@ private:
     [[nodiscard]] static constexpr CodomainType
     symmetric_sum_2_var(
         FuncType f, const DomainType& center,
-        const DomainType& half_lengths) noexcept
+        const DomainType& half_lengths)
     {
-        constexpr double gm_point = 0.9486832980505137995996680633298155601160;
-        constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
+        constexpr DomainValueType gm_point = DomainValueType(gm_point_1);
         CodomainType val{};
         DomainType point = center;
 
         for (std::size_t i = 0; i < ndim; ++i)
         {
-            const double disp1 = gm_point*half_lengths[i];
+            const DomainValueType disp1 = gm_point*half_lengths[i];
 
             point[i] = center[i] + disp1;
             for (std::size_t j = i + 1; j < ndim; ++j)
             {
-                const double disp2 = gm_point*half_lengths[j];
+                const DomainValueType disp2 = gm_point*half_lengths[j];
 
                 point[j] = center[j] + disp2;
                 val += f(point);
@@ -254,7 +688,7 @@ private:
             point[i] = center[i] - disp1;
             for (std::size_t j = i + 1; j < ndim; ++j)
             {
-                const double disp2 = gm_point*half_lengths[j];
+                const DomainValueType disp2 = gm_point*half_lengths[j];
 
                 point[j] = center[j] + disp2;
                 val += f(point);
@@ -276,18 +710,33 @@ private:
     [[nodiscard]] static constexpr CodomainType
     symmetric_sum_n_var(
         FuncType f, const DomainType& center,
-        const DomainType& half_lengths) noexcept
+        const DomainType& half_lengths)
     {
-        constexpr double gm_point = 0.6882472016116852977216287342936235251269;
-        constexpr std::size_t ndim = std::tuple_size<DomainType>::value;
+        constexpr DomainValueType gm_point = DomainValueType(gm_point_2);
         DomainType point = center + gm_point*half_lengths;
 
+        return gray_code_sum(f, center, half_lengths, point, vertex_count);
+    }
+
+    /*
+        Sum of `f` over the `count` vertices reached from `point` by a Gray code
+        walk over the lowest `log2(count)` dimensions.
+    */
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr CodomainType
+    gray_code_sum(
+        FuncType f, const DomainType& center, const DomainType& half_lengths,
+        DomainType point, std::uint64_t count)
+    {
+        constexpr DomainValueType gm_point = DomainValueType(gm_point_2);
+
         CodomainType val = f(point);
-        unsigned int gray = 0;
-        for (std::size_t i = 1; i < (1UL << ndim); ++i)
+        std::uint64_t gray = 0;
+        for (std::uint64_t i = 1; i < count; ++i)
         {
-            const unsigned int dim = ctz((unsigned int) i);
-            const unsigned int flipped_bit = 1U << dim;
+            const std::size_t dim = std::size_t(std::countr_zero(i));
+            const std::uint64_t flipped_bit = std::uint64_t(1) << dim;
             gray ^= flipped_bit;
             point[dim] = (gray & flipped_bit) ?
                     center[dim] - gm_point*half_lengths[dim]
@@ -299,18 +748,33 @@ private:
         return val;
     }
 
-    [[nodiscard]] static constexpr unsigned int
-    ctz(unsigned int n) noexcept
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static CodomainType
+    parallel_symmetric_sum_n_var(
+        FuncType f, const DomainType& center, const DomainType& half_lengths,
+        ThreadPool& pool)
     {
-    #if (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4))
-        return (unsigned int)(__builtin_ctz(n));
-    #else
-        static constexpr unsigned int table[32] = {
-            0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8, 31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
-        };
+        constexpr DomainValueType gm_point = DomainValueType(gm_point_2);
+        constexpr std::size_t chunk_ndim = ndim - chunk_prefix_ndim;
+        constexpr std::size_t chunk_count = std::size_t(1) << chunk_prefix_ndim;
+
+        std::vector<CodomainType> chunk_sums(chunk_count);
+        pool.for_each_index(chunk_count, [&](std::size_t chunk)
+        {
+            DomainType point = center + gm_point*half_lengths;
+            for (std::size_t i = 0; i < chunk_prefix_ndim; ++i)
+            {
+                const std::size_t dim = chunk_ndim + i;
+                if (chunk & (std::size_t(1) << i))
+                    point[dim] = center[dim] - gm_point*half_lengths[dim];
+            }
+            chunk_sums[chunk] = gray_code_sum(
+                    f, center, half_lengths, point,
+                    std::uint64_t(1) << chunk_ndim);
+        });
 
-        return table[((n & ~n + 1)*0x077CB531U) >> 27];
-    #endif
+        return sum(chunk_sums);
     }
 };
 
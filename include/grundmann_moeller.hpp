@@ -22,7 +22,9 @@ SOFTWARE.
 #pragma once
 
 #include <array>
-#include <span>
+#include <algorithm>
+
+#include "simplex_symmetric_sums.hpp"
 
 namespace cubage
 {
@@ -30,12 +32,13 @@ namespace cubage
 [[nodiscard]] constexpr long double uint_pow(long double x, std::size_t n)
 {
     long double res = 1.0;
-    const std::array<long double, 2> mult = {1.0, x};
-    do {
-        res *= mult[n & 1];
+    while (n)
+    {
+        if (n & 1) res *= x;
         n >>= 1;
         x *= x;
-    } while (n);
+    }
+    return res;
 }
 
 [[nodiscard]] constexpr long double factorial(std::size_t n)
@@ -45,96 +48,125 @@ namespace cubage
         res *= (long double)(i);
     return res;
 }
+
 /*
     Generator for weights and points Grundmann-Möller rules.
 
         Axel Grundmann, H. M. Möller, "Invariant Integration Formulas for the n-simplex by Combinatorial Methods", SIAM J. Numer. Anal. 15:282-290, 1978
+
+    The rule of degree 2s + 1 on an n-simplex is
+
+        Q_s f = V sum_{m = 0}^{s} w_{s,m} sum_{|b| = m} f(x_b),
+
+    where V is the volume of the simplex, b runs over the (n + 1)-tuples of 
+    non-negative integers with sum m, and x_b is the point with barycentric 
+    coordinates (2 b_j + 1)/(n + 2m + 1). The point sets do not depend on s,
+    so the rules of degree 2s - 1, 2s - 3, ..., 1 use a subset of the points 
+    of the rule of degree 2s + 1.
+
+    The point set with |b| = m splits into orbits under permutations of the 
+    barycentric coordinates, one for each partition of m into at most n + 1
+    parts.
 */
 template <std::size_t Dimension, std::size_t Order>
 struct GrundmannMoellerGenerator
 {
     static constexpr std::size_t degree = 2*Order + 1;
 
-    template <typename T, std::size_t N>
-        requires requires { N > Order; }
-    [[nodiscard]] static constexpr T evaluate(
-        const std::array<T, N>& sums)
-    {
-        constexpr std::array<T, Order + 1> weights_ = weights();
-        T val{};
-        for (std::size_t i = 0; i < weights.size(); ++i)
-            val += weights_[i]*sums[i];
-        return val;
-    }
-
+    /*
+        Weights w_{s,m} of the point sets with |b| = m for s = `Order`, 
+        normalized to a simplex of unit volume.
+    */
     [[nodiscard]] static constexpr std::array<double, Order + 1> weights()
     {
-        constexpr std::size_t deg_dim = degree + Dimension - 1;
         std::array<double, Order + 1> res{};
-        for (std::size_t i = 0; i < res.size(); ++i)
+        for (std::size_t i = 0; i <= Order; ++i)
         {
-            const long double num_arg
-                = 0.5*(long double)(deg_dim) - (long double)(i);
-            const long double numer = num_arg*uint_pow(
-                    num_arg*num_arg, Order);
-            const long double denom = factorial(i)*factorial(deg_dim - i);
+            const std::size_t m = Order - i;
+            const long double numer = uint_pow(
+                    (long double)(Dimension + 2*m + 1), degree)
+                    *factorial(Dimension);
+            const long double denom = uint_pow(2.0, 2*Order)*factorial(i)
+                    *factorial(Dimension + degree - i);
             const long double sign = (i & 1) ? -1.0 : 1.0;
-            res[res.size() - 1 - i] = double(sign*(numer/denom));
+            res[m] = double(sign*(numer/denom));
         }
-    }
-
-    [[nodiscard]] static constexpr std::array<double, Dimemnsion> center()
-    {
-        std::array<double, Dimension> res{};
-        res.fill(1.0/double(Dimension));
         return res;
     }
 
     /*
-        The following ´partition_´ functions give numbers needed to compute the generators of the rules. This is kind of a weird way of going about it, but because the same patterns occur in different generators and rules, we get more code reuse this way.
-
-        Essentially if the generator has the form (a,b,x,x,x,...,x), the first element in the ´std::pair´ is x, and the second is (a,b).
-
-        The naming convention is because the generators essentially arise from the partitions of integers, e.g. 3 = 3 = 2 + 1 = 1 + 1 + 1. See the paper.
+        Barycentric coordinates of the points with |b| = m are the odd 
+        multiples of this value.
     */
-
-    [[nodiscard]] static constexpr std::pair<double, double> 
-    generator_partition_1_to_1()
-    {
-        return {1.0/double(Dimension + 2), 3.0/double(Dimension + 2)};
-    }
-
-    [[nodiscard]] static constexpr std::pair<double, double> 
-    generator_partition_2_to_2()
-    {
-        return {1.0/double(Dimension + 4), 5.0/double(Dimension + 4)};
-    }
-
-    [[nodiscard]] static constexpr std::pair<double, double> 
-    generator_partition_2_to_2_2()
+    [[nodiscard]] static constexpr double point_set_scale(std::size_t m)
     {
-        return {1.0/double(Dimension + 4), 3.0/double(Dimension + 4)};
+        return 1.0/double(Dimension + 2*m + 1);
     }
 
-    [[nodiscard]] static constexpr std::pair<double, double> 
-    generator_partition_3_to_3()
+    /*
+        Offsets of the point sets with |b| = m in `points()`. The point set
+        with |b| = m has binomial(n + m, m) points.
+    */
+    [[nodiscard]] static constexpr std::array<std::size_t, Order + 2>
+    point_set_offsets()
     {
-        return {1.0/double(Dimension + 6), 7.0/double(Dimension + 6)};
+        std::array<std::size_t, Order + 2> res{};
+        for (std::size_t m = 0; m <= Order; ++m)
+        {
+            std::size_t count = 1;
+            for (std::size_t i = 1; i <= m; ++i)
+                count = count*(Dimension + i)/i;
+            res[m + 1] = res[m] + count;
+        }
+        return res;
     }
 
-    [[nodiscard]] static constexpr std::pair<double, std::array<double, 2>> 
-    generator_partition_3_to_2_1()
-    {
-        return {
-            1.0/double(Dimension + 6),
-            {5.0/double(Dimension + 6), 3.0/double(Dimension + 6)}
-        };
-    }
+    static constexpr std::size_t points_count = point_set_offsets()[Order + 1];
 
-    [[nodiscard]] static constexpr std::pair<double, double> 
-    generator_partition_3_to_1_1_1()
+    /*
+        Points of all point sets with |b| <= `Order`, ordered by m. Each point
+        set is generated orbit by orbit, running through the partitions of m
+        into at most n + 1 parts in reverse lexicographic order.
+    */
+    [[nodiscard]] static constexpr BarycentricTable<Dimension, points_count>
+    points()
     {
-        return {1.0/double(Dimension + 6), 3.0/double(Dimension + 6)};
+        BarycentricTable<Dimension, points_count> res{};
+        std::size_t offset = 0;
+        for (std::size_t m = 0; m <= Order; ++m)
+        {
+            const double scale = point_set_scale(m);
+            std::array<std::size_t, Order + 1> parts{};
+            parts[0] = m;
+            std::size_t part_count = 1;
+            while (true)
+            {
+                if (part_count <= Dimension + 1)
+                {
+                    std::array<double, Dimension + 1> coords;
+                    coords.fill(scale);
+                    for (std::size_t i = 0; i < part_count; ++i)
+                        coords[i] = double(2*parts[i] + 1)*scale;
+                    offset = append_symmetric_orbit<Dimension>(
+                            coords, res, offset);
+                }
+
+                // next partition: decrement the last part larger than one and
+                // split the remainder into parts no larger than it
+                std::size_t i = part_count;
+                while (i > 0 && parts[i - 1] == 1) --i;
+                if (i == 0 || parts[i - 1] == 0) break;
+                std::size_t remainder = part_count - i + 1;
+                const std::size_t max_part = --parts[i - 1];
+                part_count = i;
+                while (remainder > 0)
+                {
+                    parts[part_count] = std::min(max_part, remainder);
+                    remainder -= parts[part_count++];
+                }
+            }
+        }
+        return res;
     }
 };
 
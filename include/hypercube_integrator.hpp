@@ -21,16 +21,115 @@ SOFTWARE.
 */
 #pragma once
 
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
 #include "multi_integrator.hpp"
+#include "batch_integrator.hpp"
 #include "box_region.hpp"
 #include "genz_malik.hpp"
+#include "dynamic_genz_malik.hpp"
+#include "nested_genz_malik.hpp"
+#include "fully_symmetric.hpp"
+#include "genz_cools.hpp"
 #include "gauss_kronrod.hpp"
+#include "romberg.hpp"
 
 namespace cubage
 {
-template <std::floating_point DomainType, typename CodomainType, std::size_t Degree = 15>
-using IntervalIntegrator = MultiIntegrator<GaussKronrod<DomainType, CodomainType, Degree>>;
+template <
+    std::floating_point DomainType, typename CodomainType,
+    std::size_t Degree = 15, RegionQueue QueueType = BinaryHeapQueue>
+using IntervalIntegrator = MultiIntegrator<
+    GaussKronrod<DomainType, CodomainType, Degree>, NormIndividual, QueueType>;
+
+template <
+    std::floating_point DomainType, typename CodomainType,
+    std::size_t Levels = 4, RegionQueue QueueType = BinaryHeapQueue>
+using RombergIntegrator = MultiIntegrator<
+    Romberg<DomainType, CodomainType, Levels>, NormIndividual, QueueType>;
+
+template <
+    GenzMalikIntegrable DomainType, typename CodomainType,
+    RegionQueue QueueType = BinaryHeapQueue>
+using HypercubeIntegrator = MultiIntegrator<
+    GenzMalikD7<DomainType, CodomainType>, NormIndividual, QueueType>;
+
+/*
+    Hypercube integrator for dimensions only known at runtime. The integrand
+    takes the point as a `std::span<const double>`, and the limits are given
+    as a `DynamicBox` of up to `MaxNdim` dimensions. Every stored region 
+    holds limits for `MaxNdim` dimensions, i.e., `16*MaxNdim + 16` bytes 
+    besides its result, whatever the dimension of the integral.
+*/
+template <
+    typename CodomainType, std::size_t MaxNdim = 16,
+    RegionQueue QueueType = BinaryHeapQueue>
+using DynamicHypercubeIntegrator = MultiIntegrator<
+    DynamicGenzMalikD7<CodomainType, MaxNdim>, NormIndividual, QueueType>;
+
+/*
+    Call `visitor` with a `DynamicHypercubeIntegrator` whose `MaxNdim` is the
+    smallest of 4, 8 and 16 that is at least `ndim`, so that the memory of 
+    the regions follows the dimension only known at runtime. The integrator
+    is constructed from `args` and lives until `visitor` returns, so 
+    `visitor` must return its results by value. Throws 
+    `std::invalid_argument` if `ndim` exceeds 16.
+*/
+template <
+    typename CodomainType, RegionQueue QueueType = BinaryHeapQueue,
+    typename Visitor, typename... Args>
+auto visit_dynamic_hypercube_integrator(
+    std::size_t ndim, Visitor&& visitor, Args&&... args)
+{
+    auto visit = [&]<std::size_t MaxNdim>()
+    {
+        DynamicHypercubeIntegrator<CodomainType, MaxNdim, QueueType> integrator(
+                std::forward<Args>(args)...);
+        return visitor(integrator);
+    };
+
+    if (ndim <= 4)
+        return visit.template operator()<4>();
+    if (ndim <= 8)
+        return visit.template operator()<8>();
+    if (ndim <= 16)
+        return visit.template operator()<16>();
+    throw std::invalid_argument(
+            "invalid integration limits: unsupported dimension");
+}
+
+template <
+    GenzMalikIntegrable DomainType, typename CodomainType,
+    std::size_t Degree = 7, RegionQueue QueueType = BinaryHeapQueue>
+using HypercubeIntegratorOfDegree = MultiIntegrator<
+    HypercubeRule<DomainType, CodomainType, Degree>, NormIndividual, QueueType>;
+
+template <
+    GenzMalikIntegrable DomainType, typename CodomainType,
+    RegionQueue QueueType = BinaryHeapQueue>
+using NestedHypercubeIntegrator = MultiIntegrator<
+    NestedGenzMalikD7<DomainType, CodomainType>, NormIndividual, QueueType>;
+
+template <
+    std::floating_point DomainType, typename CodomainType,
+    std::size_t Degree = 15, RegionQueue QueueType = BinaryHeapQueue>
+using BatchIntervalIntegrator = BatchIntegrator<
+    GaussKronrod<DomainType, CodomainType, Degree>, NormIndividual, QueueType>;
+
+template <
+    GenzMalikIntegrable DomainType, typename CodomainType,
+    RegionQueue QueueType = BinaryHeapQueue>
+using BatchHypercubeIntegrator = BatchIntegrator<
+    GenzMalikD7<DomainType, CodomainType>, NormIndividual, QueueType>;
+
+template <typename Rule>
+using IntegrationSimplex = IntegrationRegion<Rule>;
 
-template <GenzMalikIntegrable DomainType, typename CodomainType>
-using HypercubeIntegrator = MultiIntegrator<GenzMalikD7<DomainType, CodomainType>>;
+template <
+    GenzCoolsIntegrable DomainType, typename CodomainType,
+    std::size_t Degree = 7, RegionQueue QueueType = BinaryHeapQueue>
+using SimplexIntegrator = MultiIntegrator<
+    GenzCools<DomainType, CodomainType, Degree>, NormIndividual, QueueType>;
 }
\ No newline at end of file
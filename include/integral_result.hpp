@@ -21,6 +21,8 @@ SOFTWARE.
 */
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <concepts>
 #include <utility>
 
@@ -57,6 +59,100 @@ template <typename T>
 concept RealVector = std::floating_point<T>
         || (FloatingPointVectorOperable<T> && ArrayLike<T>);
 
+// Floating-point type of the components of a `RealVector`.
+template <typename T>
+struct RealComponent { using type = typename T::value_type; };
+
+template <std::floating_point T>
+struct RealComponent<T> { using type = T; };
+
+template <typename T>
+using real_component_t = typename RealComponent<T>::type;
+
+/*
+    Linear combination `(scale*weights[0])*values[0] + ... + 
+    (scale*weights[N - 1])*values[N - 1]` of the first `N` values.
+
+    For array-like values, each component is accumulated in a single pass 
+    over the values, instead of creating a temporary for every product and 
+    sum as with the operators of array_arithmetic.hpp. The terms are summed in
+    the same order, so the result is identical.
+*/
+template <RealVector T, std::size_t N, std::size_t M>
+    requires (N >= 1 && N <= M)
+[[nodiscard]] constexpr T weighted_sum(
+    double scale, const std::array<double, N>& weights,
+    const std::array<T, M>& values) noexcept
+{
+    std::array<double, N> scaled_weights;
+    for (std::size_t k = 0; k < N; ++k)
+        scaled_weights[k] = scale*weights[k];
+
+    if constexpr (std::floating_point<T>)
+    {
+        T res = scaled_weights[0]*values[0];
+        for (std::size_t k = 1; k < N; ++k)
+            res += scaled_weights[k]*values[k];
+        return res;
+    }
+    else
+    {
+        T res;
+        for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
+        {
+            typename T::value_type component = scaled_weights[0]*values[0][i];
+            for (std::size_t k = 1; k < N; ++k)
+                component += scaled_weights[k]*values[k][i];
+            res[i] = component;
+        }
+        return res;
+    }
+}
+
+/*
+    Error estimate from the magnitudes `errors[0], errors[1], ...` of null 
+    rules of decreasing degree, following Berntsen, Espelid and Genz. If the
+    null rules increase with decreasing degree, the integrand is taken to be
+    in the asymptotic regime, where the error of the rule is smaller than 
+    `errors[0]` by about the largest ratio `r` of consecutive null rules, or 
+    its square if `r < critical_ratio`. Since a very small ratio is weak 
+    evidence of fast convergence, it is bounded below by `min_ratio`. 
+    Otherwise `safety_factor` times the largest null rule is used as a 
+    conservative estimate.
+*/
+template <std::size_t N>
+    requires (N >= 2)
+[[nodiscard]] constexpr double null_rule_error_estimate(
+    const std::array<double, N>& errors, double min_ratio,
+    double safety_factor = 10.0, double critical_ratio = 0.5) noexcept
+{
+    double r = 0.0;
+    bool asymptotic = true;
+    for (std::size_t k = 0; k + 1 < N; ++k)
+    {
+        if (errors[k] >= errors[k + 1])
+        {
+            asymptotic = false;
+            break;
+        }
+        r = std::max(r, errors[k]/errors[k + 1]);
+    }
+
+    if (!asymptotic)
+    {
+        double max_error = errors[0];
+        for (std::size_t k = 1; k < N; ++k)
+            max_error = std::max(max_error, errors[k]);
+        return safety_factor*max_error;
+    }
+
+    if (r >= critical_ratio)
+        return safety_factor*r*errors[0];
+
+    const double ratio = std::max(r, min_ratio);
+    return (safety_factor/critical_ratio)*ratio*ratio*errors[0];
+}
+
 template <typename ValueType, typename StatusType>
 struct Result
 {
@@ -70,7 +166,8 @@ struct Result
 enum class Status
 {
     SUCCESS,
-    MAX_SUBDIV
+    MAX_SUBDIV,
+    MAX_MEMORY
 };
 
 template <typename T>
@@ -116,4 +213,73 @@ struct IntegralResult
     }
 };
 
+/*
+    Running sum of integral results with Neumaier's variant of compensated 
+    summation
+
+        A. Neumaier, "Rundungsfehleranalyse einiger Verfahren zur Summation 
+        endlicher Summen", Z. Angew. Math. Mech. 54:39-51, 1974
+
+    The rounding error of each addition is accumulated separately, so the 
+    error of the sum does not grow with the number of updates, as long as the
+    magnitude of the sum stays comparable to that of its terms. Adaptive 
+    integrators update the integral estimate by adding the results of the 
+    subregions and subtracting that of their parent millions of times, which
+    would otherwise need a final resummation over all regions.
+*/
+template <typename T>
+struct CompensatedResult
+{
+    IntegralResult<T> sum{};
+    IntegralResult<T> compensation{};
+
+    constexpr CompensatedResult() = default;
+
+    explicit constexpr CompensatedResult(const IntegralResult<T>& x) noexcept:
+        sum(x), compensation{} {}
+
+    [[nodiscard]] constexpr IntegralResult<T> value() const noexcept
+    {
+        return sum + compensation;
+    }
+
+    constexpr CompensatedResult& operator+=(const IntegralResult<T>& x) noexcept
+    {
+        add<false>(sum.val, compensation.val, x.val);
+        add<false>(sum.err, compensation.err, x.err);
+        return *this;
+    }
+
+    constexpr CompensatedResult& operator-=(const IntegralResult<T>& x) noexcept
+    {
+        add<true>(sum.val, compensation.val, x.val);
+        add<true>(sum.err, compensation.err, x.err);
+        return *this;
+    }
+
+private:
+    template <bool Subtract>
+    static constexpr void add(T& s, T& c, const T& x) noexcept
+    {
+        if constexpr (std::is_floating_point<T>::value)
+            add_component(s, c, Subtract ? -x : x);
+        else
+        {
+            for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
+                add_component(s[i], c[i], Subtract ? -x[i] : x[i]);
+        }
+    }
+
+    template <std::floating_point U>
+    static constexpr void add_component(U& s, U& c, U x) noexcept
+    {
+        const U t = s + x;
+        if ((s < 0 ? -s : s) >= (x < 0 ? -x : x))
+            c += (s - t) + x;
+        else
+            c += (x - t) + s;
+        s = t;
+    }
+};
+
 }
\ No newline at end of file
@@ -45,7 +45,7 @@ struct Interval
 
     [[nodiscard]] constexpr inline FieldType center() const noexcept
     {
-        return 0.5*(xmax + xmin);
+        return FieldType(0.5)*(xmax + xmin);
     }
 };
 
@@ -96,8 +96,9 @@ public:
     }
 
     template <typename Rule, typename FuncType>
-        requires MapsAs<FuncType, DomainType, typename Rule::CodomainType> && IntervalIntegratorSignature<Rule>
-    constexpr const IntegralResult<typename Rule::CodomainType> integrate(FuncType f) noexcept
+        requires Integrand<FuncType, DomainType, typename Rule::CodomainType>
+            && IntervalIntegratorSignature<Rule>
+    constexpr const IntegralResult<typename Rule::CodomainType> integrate(FuncType f)
     {
         return Rule::integrate(f, m_limits);
     }
@@ -106,4 +107,84 @@ private:
     Limits m_limits{};
 };
 
+template <typename FieldType>
+concept NestedIntervalIntegratorSignature
+= requires (
+    typename FieldType::CodomainType (*f)(typename FieldType::DomainType),
+    typename FieldType::Limits limits,
+    std::array<typename FieldType::CodomainType, FieldType::points_count()>& values,
+    bool reuse)
+{
+    { FieldType::integrate(f, limits, values, reuse) } -> std::same_as<IntegralResult<typename FieldType::CodomainType>>;
+};
+
+/*
+    Interval, which stores the function values at the nodes of a rule whose
+    nodes are nested under bisection: the nodes with even index of either half
+    of the interval coincide with the first or second half of the nodes of the
+    whole interval. When subdivided, the halves inherit these values, and the
+    rule only needs to evaluate the function at the nodes with odd index.
+*/
+template <typename Domain, typename Codomain, std::size_t NodeCount>
+    requires std::floating_point<Domain> && (NodeCount % 2 == 1)
+class NestedSubdivisibleInterval
+{
+public:
+    using DomainType = Domain;
+    using CodomainType = Codomain;
+    using Limits = Interval<DomainType>;
+
+    constexpr NestedSubdivisibleInterval() = default;
+
+    constexpr NestedSubdivisibleInterval(
+        const DomainType& p_xmin, const DomainType& p_xmax):
+        NestedSubdivisibleInterval(Limits{p_xmin, p_xmax}) {}
+
+    explicit constexpr NestedSubdivisibleInterval(const Limits& p_limits):
+        m_limits(p_limits)
+    {
+        if (m_limits.length() <= 0)
+            throw std::invalid_argument(
+                    "invalid integration limits: max <= min");
+    }
+
+    [[nodiscard]] constexpr const Limits&
+    limits() const noexcept { return m_limits; }
+
+    [[nodiscard]] constexpr std::pair<NestedSubdivisibleInterval, NestedSubdivisibleInterval>
+    subdivide() const noexcept
+    {
+        constexpr std::size_t half = NodeCount/2;
+        const DomainType mid = m_limits.center();
+
+        std::pair<NestedSubdivisibleInterval, NestedSubdivisibleInterval> intervals = {
+            NestedSubdivisibleInterval(m_limits.xmin, mid),
+            NestedSubdivisibleInterval(mid, m_limits.xmax)
+        };
+
+        for (std::size_t i = 0; i <= half; ++i)
+        {
+            intervals.first.m_values[2*i] = m_values[i];
+            intervals.second.m_values[2*i] = m_values[half + i];
+        }
+        intervals.first.m_has_parent_values = true;
+        intervals.second.m_has_parent_values = true;
+
+        return intervals;
+    }
+
+    template <typename Rule, typename FuncType>
+        requires MapsAs<FuncType, DomainType, typename Rule::CodomainType>
+            && NestedIntervalIntegratorSignature<Rule>
+    constexpr const IntegralResult<typename Rule::CodomainType> integrate(FuncType f)
+    {
+        return Rule::integrate(f, m_limits, m_values, m_has_parent_values);
+    }
+
+private:
+    Limits m_limits{};
+    std::array<CodomainType, NodeCount> m_values{};
+    bool m_has_parent_values = false;
+};
+
 }
\ No newline at end of file
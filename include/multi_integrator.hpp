@@ -22,6 +22,7 @@ SOFTWARE.
 #pragma once
 
 #include <vector>
+#include <array>
 #include <algorithm>
 #include <ranges>
 #include <utility>
@@ -29,17 +30,30 @@ SOFTWARE.
 #include <type_traits>
 #include <concepts>
 #include <span>
+#include <memory>
+#include <memory_resource>
 
 #include <iostream>
 
 #include "integral_result.hpp"
 #include "concepts.hpp"
+#include "thread_pool.hpp"
+#include "region_store.hpp"
 
 namespace cubage
 {
 
 struct NormIndividual {};
 
+/*
+    Convergence criterion for vector-valued codomains, where each component is
+    tested individually like with `NormIndividual`. In addition, a component
+    which satisfies the tolerances is retired: its error no longer contributes
+    to the priority of the regions, so that the remaining components alone
+    determine which regions are subdivided.
+*/
+struct NormComponentwise {};
+
 template <typename FieldType>
 concept BiSubdivisible = requires (FieldType x, typename FieldType::CodomainType (*f)(typename FieldType::DomainType))
 {
@@ -86,10 +100,14 @@ public:
     explicit constexpr IntegrationRegion(const RegionType& p_region):
         m_region(p_region) {}
 
+    constexpr IntegrationRegion(
+        const RegionType& p_region, const Result& p_result, double p_maxerr):
+        m_region(p_region), m_result(p_result), m_maxerr(p_maxerr) {}
+
     template <typename FuncType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
+        requires Integrand<FuncType, DomainType, CodomainType>
     [[nodiscard]] constexpr std::pair<IntegrationRegion, IntegrationRegion>
-    subdivide(FuncType f) const noexcept
+    subdivide(FuncType f) const
     {
         const auto& [left, right] = m_region.subdivide();
 
@@ -103,15 +121,56 @@ public:
     }
 
     template <typename FuncType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
-    constexpr const IntegralResult<CodomainType>& integrate(FuncType f) noexcept
+        requires Integrand<FuncType, DomainType, CodomainType>
+    constexpr const IntegralResult<CodomainType>& integrate(FuncType f)
     {
         m_result = m_region.template integrate<RuleType>(f);
+        m_maxerr = max_error(m_result);
+        return m_result;
+    }
+
+    // Variants of `subdivide` and `integrate` for rules which evaluate the 
+    // points of a single region in parallel on `pool`.
+    template <typename FuncType, typename PoolType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+            && requires (RegionType region, FuncType f, PoolType& pool)
+            {
+                region.template integrate<RuleType>(f, pool);
+            }
+    [[nodiscard]] std::pair<IntegrationRegion, IntegrationRegion>
+    subdivide(FuncType f, PoolType& pool) const
+    {
+        const auto& [left, right] = m_region.subdivide();
+
+        std::pair<IntegrationRegion, IntegrationRegion> regions = {
+            IntegrationRegion(left), IntegrationRegion(right)
+        };
+        regions.first.integrate(f, pool);
+        regions.second.integrate(f, pool);
+
+        return regions;
+    }
+
+    template <typename FuncType, typename PoolType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+            && requires (RegionType region, FuncType f, PoolType& pool)
+            {
+                region.template integrate<RuleType>(f, pool);
+            }
+    const IntegralResult<CodomainType>& integrate(FuncType f, PoolType& pool)
+    {
+        m_result = m_region.template integrate<RuleType>(f, pool);
+        m_maxerr = max_error(m_result);
+        return m_result;
+    }
+
+    [[nodiscard]] static constexpr double
+    max_error(const Result& result) noexcept
+    {
         if constexpr (std::is_floating_point<CodomainType>::value)
-            m_maxerr = m_result.err;
+            return double(result.err);
         else
-            m_maxerr = *std::ranges::max_element(m_result.err);
-        return m_result;
+            return double(*std::ranges::max_element(result.err));
     }
 
     [[nodiscard]] constexpr const IntegralResult<CodomainType>&
@@ -133,12 +192,92 @@ public:
     [[nodiscard]] constexpr const Limits&
     limits() const noexcept { return m_region.limits(); }
 
+    [[nodiscard]] constexpr const RegionType&
+    region() const noexcept { return m_region; }
+
 private:
     RegionType m_region{};
     IntegralResult<CodomainType> m_result{};
     double m_maxerr{};
 };
 
+/*
+    Test whether an integral satisfies the absolute or relative tolerance. For
+    vector-valued integrals, the errors are either tested component by
+    component (`NormIndividual`), or reduced with `NormType::norm`.
+*/
+template <typename NormType, typename CodomainType>
+[[nodiscard]] constexpr bool is_converged(
+    const IntegralResult<CodomainType>& res, double abserr,
+    double relerr) noexcept
+{
+    if constexpr (std::floating_point<CodomainType>)
+        return res.err <= abserr || res.err <= std::fabs(res.val)*relerr;
+    else if constexpr (std::is_same_v<NormType, NormIndividual>)
+    {
+        for (std::size_t i = 0; i < res.ndim(); ++i)
+        {
+            if (res.err[i] > abserr
+                    && res.err[i] > std::fabs(res.val[i])*relerr)
+                return false;
+        }
+        return true;
+    }
+    else
+    {
+        const double norm_val = NormType::norm(res.val);
+        const double norm_err = NormType::norm(res.err);
+
+        return norm_err <= abserr || norm_err <= norm_val*relerr;
+    }
+}
+
+/*
+    Largest error of each region, as measured by `IntegrationRegion::max_error`,
+    such that the integral `res` still satisfies the tolerances if the errors
+    of all regions were that large and added up. For norms other than 
+    `NormIndividual`, the norm is assumed to be monotone in the magnitude of 
+    each component.
+*/
+template <typename NormType, typename CodomainType>
+[[nodiscard]] constexpr double error_tolerance(
+    const IntegralResult<CodomainType>& res, double abserr,
+    double relerr) noexcept
+{
+    if constexpr (std::floating_point<CodomainType>)
+        return std::max(abserr, double(std::fabs(res.val)*relerr));
+    else if constexpr (std::is_same_v<NormType, NormIndividual>
+            || std::is_same_v<NormType, NormComponentwise>)
+    {
+        double tolerance = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < res.ndim(); ++i)
+            tolerance = std::min(
+                    tolerance, std::max(abserr, double(std::fabs(res.val[i])*relerr)));
+        return tolerance;
+    }
+    else
+    {
+        CodomainType ones = res.val;
+        std::ranges::fill(ones, 1.0);
+        return std::max(abserr, NormType::norm(res.val)*relerr)
+            /NormType::norm(ones);
+    }
+}
+
+/*
+    Rule with a variant of `integrate` which integrates over up to 
+    `batch_size` regions at once, such as `GaussKronrod`.
+*/
+template <typename Rule>
+concept MultiRegionRule = requires (
+    typename Rule::CodomainType (*f)(typename Rule::DomainType),
+    std::span<const typename Rule::Limits> limits,
+    std::span<IntegralResult<typename Rule::CodomainType>> results)
+{
+    { Rule::batch_size } -> std::convertible_to<std::size_t>;
+    Rule::integrate(f, limits, results);
+};
+
 template <typename FieldType>
 concept SubdivisionIntegrable
     = WeaklyOrdered<FieldType> && Limited<FieldType> && Integrating<FieldType> && BiSubdivisible<FieldType>
@@ -152,7 +291,43 @@ template <typename T, typename ValueType>
 concept ValueOrSizedRangeOf
     = std::same_as<std::remove_cvref_t<T>, ValueType> || SizedRangeOf<T, ValueType>;
 
-template <typename RuleType, typename NormType = NormIndividual>
+/*
+    Adaptive integrator, which repeatedly subdivides the region with the
+    largest error estimate until the requested tolerance is reached.
+
+    The order in which regions are subdivided is determined by `QueueType`.
+    The default `BinaryHeapQueue` always subdivides the region with the largest
+    error. `QuaternaryHeapQueue` gives the same order with a shallower heap,
+    while `BucketQueue` and `LazySortQueue` trade exact ordering for cheaper
+    queue operations, which may pay off for cheap integrands.
+
+    The regions are stored in chunks obtained from `Allocator`, which are 
+    never moved when the number of regions grows. Integrators using a 
+    `std::pmr::polymorphic_allocator`, see `pmr::MultiIntegrator`, can share 
+    a single memory resource.
+
+    With `set_memory_limit`, the number of stored regions is bounded. When the
+    limit is reached, the regions with the smallest errors are retired: their
+    results are added to a running sum and they are no longer stored or 
+    subdivided. Regions are only retired as long as their total error stays
+    below half the tolerance. Each time, at least an eighth of the stored 
+    regions must be retired, so the cost of retiring stays amortized; if that
+    is not possible, `refine` stops with `Status::MAX_MEMORY`.
+
+    For rules which integrate over several regions at once, such as 
+    `GaussKronrod`, and batched integrands, the regions whose error is at 
+    least half the largest error are subdivided together, so that the 
+    integrand is called once with the points of up to `RuleType::batch_size`
+    subregions.
+
+    Exceptions thrown by the integrand propagate out of `integrate` and 
+    `refine`. The stored regions are then incomplete, so the integral must be
+    started afresh with `integrate`.
+*/
+template <
+    typename RuleType, typename NormType = NormIndividual,
+    RegionQueue QueueType = BinaryHeapQueue,
+    typename Allocator = std::allocator<std::byte>>
 class MultiIntegrator
 {
 public:
@@ -161,40 +336,132 @@ public:
     using CodomainType = typename RegionType::CodomainType;
     using DomainType = typename RegionType::DomainType;
     using ResultType = IntegralResult<CodomainType>;
+    using allocator_type = Allocator;
+    using RegionStoreType = RegionStore<RegionType, QueueType, Allocator>;
+
+    // Memory used per stored region.
+    static constexpr std::size_t region_bytes
+        = sizeof(typename RegionType::RegionType) + sizeof(ResultType)
+        + sizeof(RegionKey);
 
     MultiIntegrator() = default;
 
+    explicit MultiIntegrator(const Allocator& alloc): m_regions(alloc) {}
+
+    /*
+        Construct an integrator which subdivides regions in parallel on
+        `num_threads` threads. At each step, all regions whose error is at
+        least `batch_fraction` times the largest error are subdivided
+        simultaneously. The regions of a batch are processed independently
+        and merged back in a fixed order, so the result does not depend on
+        the number of threads. For rules which can evaluate a single region 
+        in parallel, such as `GenzMalikD7`, regions with at least 2^16 
+        points, i.e., hypercubes in 16 or more dimensions, are instead 
+        subdivided one at a time, with the points of each region evaluated
+        in parallel. The result may then differ from the serial integrator 
+        by rounding, but still does not depend on the number of threads.
+
+        In this mode, the integrand is called concurrently from multiple
+        threads, and must therefore be safe to call concurrently. Copies of
+        the integrator share its threads.
+    */
+    explicit MultiIntegrator(
+        std::size_t num_threads, double batch_fraction = 0.5,
+        const Allocator& alloc = Allocator()):
+        m_regions(alloc),
+        m_thread_pool((num_threads > 1) ?
+            std::make_shared<ThreadPool>(num_threads) : nullptr),
+        m_batch_fraction(batch_fraction) {}
+
     template <typename FuncType, typename LimitsType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
+        requires Integrand<FuncType, DomainType, CodomainType>
             && ValueOrSizedRangeOf<LimitsType, Limits>
     [[nodiscard]] Result<ResultType, Status> integrate(
             FuncType f, LimitsType&& integration_domain,
             double abserr, double relerr,
             std::size_t max_subdiv = std::numeric_limits<std::size_t>::max())
     {
-        if constexpr (SizedRangeOf<LimitsType, Limits>)
-            m_region_eval_count = std::ranges::size(integration_domain);
-        else
-            m_region_eval_count = 1;
-        generate_region_heap(integration_domain);
-        ResultType res = integrate_initial_regions(f);
+        m_region_eval_count = 0;
+        m_func_eval_count = 0;
+        m_retired_result = ResultType{};
+        m_retired_maxerr = 0.0;
+        m_retired_region_count = 0;
+        m_result = integrate_initial_regions(f, integration_domain);
+
+        return refine(f, abserr, relerr, max_subdiv);
+    }
 
-        while (!has_converged(res, abserr, relerr) && m_region_heap.size() < max_subdiv)
-            subdivide_top_region(f, res);
-        
-        // resum to minimize spooky floating point error accumulation
-        res = ResultType{};
-        for (const auto& region : m_region_heap)
-            res += region.result();
-        
-        Status status = (m_region_heap.size() >= max_subdiv) ? 
-            Status::MAX_SUBDIV : Status::SUCCESS;
-        return {res, status};
+    /*
+        Continue subdividing the regions left by the previous call to 
+        `integrate` or `refine` until the integral satisfies the given 
+        tolerances, or the number of regions reaches `max_subdiv`. No work 
+        done by previous calls is repeated, so an integral can be computed to 
+        progressively tighter tolerances at the cost of computing it once to 
+        the tightest tolerance.
+
+        The integrand must be the same as in the call to `integrate`.
+    */
+    template <typename FuncType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+    [[nodiscard]] Result<ResultType, Status> refine(
+            FuncType f, double abserr, double relerr,
+            std::size_t max_subdiv = std::numeric_limits<std::size_t>::max())
+    {
+        CompensatedResult<CodomainType> res(m_result);
+        if constexpr (componentwise)
+            activate_components(m_result);
+
+        Status status = Status::SUCCESS;
+        while (!m_regions.empty() && !has_converged(res.value(), abserr, relerr)
+                && m_regions.size() < max_subdiv)
+        {
+            if (m_regions.size() >= m_max_regions
+                    && !retire_negligible_regions(res.value(), abserr, relerr))
+            {
+                status = Status::MAX_MEMORY;
+                break;
+            }
+
+            if constexpr (parallel_region_rule<FuncType>)
+            {
+                if (integrates_regions_in_parallel<FuncType>())
+                {
+                    subdivide_top_region_in_parallel(f, res);
+                    continue;
+                }
+            }
+
+            if (m_thread_pool)
+                subdivide_top_regions(
+                        f, res, std::min(max_subdiv, m_max_regions));
+            else if constexpr (MultiRegionRule<RuleType>
+                    && BatchMapsAs<FuncType, DomainType, CodomainType>)
+                subdivide_top_regions_together(
+                        f, res, std::min(max_subdiv, m_max_regions));
+            else
+                subdivide_top_region(f, res);
+        }
+
+        m_result = res.value();
+        if (m_regions.size() >= max_subdiv)
+            status = Status::MAX_SUBDIV;
+        return {m_result, status};
+    }
+
+    /*
+        Status of each component of the integral after the previous call to 
+        `integrate` or `refine`. A component has status `Status::SUCCESS` if it 
+        satisfied the tolerances and was retired.
+    */
+    [[nodiscard]] std::span<const Status> component_status() const noexcept
+        requires std::same_as<NormType, NormComponentwise>
+    {
+        return std::span(m_component_status);
     }
 
     [[nodiscard]] std::size_t func_eval_count() const noexcept
     {
-        return m_region_eval_count*RuleType::points_count();
+        return m_func_eval_count;
     }
 
     [[nodiscard]] std::size_t region_eval_count() const noexcept
@@ -204,110 +471,468 @@ public:
 
     [[nodiscard]] std::size_t region_count() const noexcept
     {
-        return m_region_heap.size();
+        return m_regions.size();
+    }
+
+    /*
+        Limit the memory used for storing regions to about `max_bytes`. See
+        `region_bytes` for the memory used per region.
+    */
+    void set_memory_limit(std::size_t max_bytes) noexcept
+    {
+        m_max_regions = std::max<std::size_t>(max_bytes/region_bytes, 2);
     }
 
-    [[nodiscard]] std::span<const RegionType> regions() const noexcept
+    // Number of regions retired because of the memory limit.
+    [[nodiscard]] std::size_t retired_region_count() const noexcept
     {
-        return std::span(m_region_heap);
+        return m_retired_region_count;
+    }
+
+    // Sum of the results of the retired regions.
+    [[nodiscard]] const ResultType& retired_result() const noexcept
+    {
+        return m_retired_result;
+    }
+
+    [[nodiscard]] const typename RegionStoreType::SubregionArena&
+    regions() const noexcept
+    {
+        return m_regions.regions();
+    }
+
+    [[nodiscard]] const typename RegionStoreType::ResultArena&
+    results() const noexcept
+    {
+        return m_regions.results();
     }
 
     [[nodiscard]] std::size_t capacity() const noexcept
     {
-        return m_region_heap.capacity();
+        return m_regions.capacity();
+    }
+
+    /*
+        Write the state of the integrator, i.e., its regions with their limits,
+        results and any rule-specific data, the integral estimate, the 
+        evaluation counts and the status of each component, to a binary 
+        checkpoint. The integration can be continued from the checkpoint by 
+        calling `load` followed by `refine`.
+    */
+    void save(std::ostream& out) const
+    {
+        m_regions.save(out);
+        write_binary(out, std::uint64_t(m_region_eval_count));
+        write_binary(out, std::uint64_t(m_func_eval_count));
+        write_binary(out, m_result);
+        write_binary(out, m_retired_result);
+        write_binary(out, m_retired_maxerr);
+        write_binary(out, std::uint64_t(m_retired_region_count));
+        write_binary(out, m_component_status);
+        if (!out)
+            throw std::runtime_error("failed to write checkpoint");
+    }
+
+    /*
+        Restore the state of the integrator from a checkpoint written by 
+        `save`, without evaluating the integrand. Throws `std::runtime_error` 
+        if the checkpoint is malformed, or was written by an integrator of a 
+        different type. The state is only replaced once the whole checkpoint 
+        has been read, so a failed load leaves the integrator unchanged.
+    */
+    void load(std::istream& in)
+    {
+        RegionStoreType regions(m_regions.get_allocator());
+        regions.load(in);
+        std::uint64_t region_eval_count;
+        std::uint64_t func_eval_count;
+        ResultType result;
+        ResultType retired_result;
+        double retired_maxerr;
+        std::uint64_t retired_region_count;
+        read_binary(in, region_eval_count);
+        read_binary(in, func_eval_count);
+        read_binary(in, result);
+        read_binary(in, retired_result);
+        read_binary(in, retired_maxerr);
+        read_binary(in, retired_region_count);
+        std::vector<Status> component_status;
+        read_binary(in, component_status);
+        if (!component_status.empty())
+        {
+            if (!componentwise || component_status.size() != result.ndim())
+                throw std::runtime_error(
+                        "invalid checkpoint: bad number of component statuses");
+            for (const Status status : component_status)
+            {
+                if (status != Status::SUCCESS && status != Status::MAX_SUBDIV)
+                    throw std::runtime_error(
+                            "invalid checkpoint: bad component status");
+            }
+        }
+
+        m_regions = std::move(regions);
+        m_region_eval_count = std::size_t(region_eval_count);
+        m_func_eval_count = std::size_t(func_eval_count);
+        m_result = result;
+        m_retired_result = retired_result;
+        m_retired_maxerr = retired_maxerr;
+        m_retired_region_count = std::size_t(retired_region_count);
+        m_component_status = std::move(component_status);
     }
 
 private:
+    template <typename FuncType, typename LimitsRange>
+        requires Integrand<FuncType, DomainType, CodomainType>
+            && SizedRangeOf<LimitsRange, Limits>
+    [[nodiscard]] inline ResultType
+    integrate_initial_regions(FuncType f, LimitsRange&& limits)
+    {
+        m_regions.clear();
+        m_regions.reserve(std::ranges::size(limits));
+
+        CompensatedResult<CodomainType> res{};
+        for (const auto& limit : limits)
+            res += integrate_initial_region(f, limit);
+
+        return res.value();
+    }
+
     template <typename FuncType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
-    [[nodiscard]] inline ResultType integrate_initial_regions(FuncType f)
+        requires Integrand<FuncType, DomainType, CodomainType>
+    [[nodiscard]] inline ResultType
+    integrate_initial_regions(FuncType f, const Limits& limits)
     {
-        ResultType res{};
-        for (auto& region : m_region_heap)
-            res += region.integrate(f);
-        std::ranges::make_heap(m_region_heap);
+        m_regions.clear();
+        return integrate_initial_region(f, limits);
+    }
 
+    template <typename FuncType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+    [[nodiscard]] inline ResultType
+    integrate_initial_region(FuncType f, const Limits& limits)
+    {
+        RegionType region(limits);
+        ResultType res;
+        if constexpr (parallel_region_rule<FuncType>)
+            res = integrates_regions_in_parallel<FuncType>() ?
+                region.integrate(f, *m_thread_pool) : region.integrate(f);
+        else
+            res = region.integrate(f);
+        m_regions.push(region);
+        ++m_region_eval_count;
+        m_func_eval_count += points_count(limits);
         return res;
     }
 
     template <typename FuncType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
-    inline void subdivide_top_region(FuncType f, ResultType& res)
+        requires Integrand<FuncType, DomainType, CodomainType>
+    inline void subdivide_top_region(
+        FuncType f, CompensatedResult<CodomainType>& res)
     {
-        m_region_eval_count += 2;
         const RegionType top_region = pop_top_region();
+        m_region_eval_count += 2;
+        m_func_eval_count += 2*subdivision_points_count(top_region.limits());
 
         const std::pair<RegionType, RegionType> new_regions
             = top_region.subdivide(f);
         
-        res += new_regions.first.result() + new_regions.second.result()
-            - top_region.result();
+        res += new_regions.first.result();
+        res += new_regions.second.result();
+        res -= top_region.result();
+
+        push_to_heap(new_regions.first);
+        push_to_heap(new_regions.second);
+    }
+
+    // Rules such as `GenzMalikD7` can evaluate the points of a single region
+    // in parallel. This pays off once a region has enough points, which is 
+    // in high dimensions, where a region alone keeps all threads busy. 
+    // Parallelizing over a batch of regions instead would leave threads idle
+    // while few regions exist, and the initial region serial.
+    static constexpr std::size_t min_parallel_region_points
+        = std::size_t(1) << 16;
+
+    template <typename FuncType>
+    static constexpr bool parallel_region_rule
+        = requires (RegionType region, FuncType f, ThreadPool& pool)
+        {
+            region.integrate(f, pool);
+            { RuleType::points_count() } -> std::convertible_to<std::size_t>;
+        };
+
+    template <typename FuncType>
+        requires parallel_region_rule<FuncType>
+    [[nodiscard]] bool integrates_regions_in_parallel() const noexcept
+    {
+        return m_thread_pool
+            && RuleType::points_count() >= min_parallel_region_points;
+    }
+
+    template <typename FuncType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+    void subdivide_top_region_in_parallel(
+        FuncType f, CompensatedResult<CodomainType>& res)
+    {
+        const RegionType top_region = pop_top_region();
+        m_region_eval_count += 2;
+        m_func_eval_count += 2*subdivision_points_count(top_region.limits());
+
+        const std::pair<RegionType, RegionType> new_regions
+            = top_region.subdivide(f, *m_thread_pool);
+
+        res += new_regions.first.result();
+        res += new_regions.second.result();
+        res -= top_region.result();
 
         push_to_heap(new_regions.first);
         push_to_heap(new_regions.second);
     }
 
+    template <typename FuncType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+    void subdivide_top_regions(
+        FuncType f, CompensatedResult<CodomainType>& res, std::size_t max_subdiv)
+    {
+        const double threshold = m_batch_fraction*m_regions.top_maxerr();
+        const std::size_t max_batch_size = max_subdiv - m_regions.size();
+
+        m_batch.clear();
+        do
+            m_batch.push_back(pop_top_region());
+        while (!m_regions.empty() && m_batch.size() < max_batch_size
+                && m_regions.top_maxerr() >= threshold);
+
+        m_region_eval_count += 2*m_batch.size();
+        for (const RegionType& region : m_batch)
+            m_func_eval_count += 2*subdivision_points_count(region.limits());
+        m_batch_children.resize(m_batch.size());
+        m_thread_pool->for_each_index(m_batch.size(), [&](std::size_t i)
+        {
+            m_batch_children[i] = m_batch[i].subdivide(f);
+        });
+
+        for (std::size_t i = 0; i < m_batch.size(); ++i)
+        {
+            const auto& [first, second] = m_batch_children[i];
+            res += first.result();
+            res += second.result();
+            res -= m_batch[i].result();
+            push_to_heap(first);
+            push_to_heap(second);
+        }
+    }
+
+    /*
+        Subdivide the regions whose error is at least `m_batch_fraction` times
+        the largest error, up to half the batch size of the rule, and 
+        integrate over all their subregions with one call of the 
+        multi-region variant of the rule. Used for batched integrands, which 
+        then receive the points of all subregions in one call.
+    */
+    template <typename FuncType>
+        requires Integrand<FuncType, DomainType, CodomainType>
+            && MultiRegionRule<RuleType>
+    void subdivide_top_regions_together(
+        FuncType f, CompensatedResult<CodomainType>& res, std::size_t max_subdiv)
+    {
+        using Subregion = typename RegionType::RegionType;
+        constexpr std::size_t max_batch_size = RuleType::batch_size/2;
+        const double threshold = m_batch_fraction*m_regions.top_maxerr();
+        const std::size_t batch_size_limit = std::min(
+                max_batch_size, max_subdiv - m_regions.size());
+
+        std::array<RegionType, max_batch_size> parents;
+        std::size_t batch_size = 0;
+        do
+            parents[batch_size++] = pop_top_region();
+        while (!m_regions.empty() && batch_size < batch_size_limit
+                && m_regions.top_maxerr() >= threshold);
+
+        std::array<Subregion, 2*max_batch_size> children;
+        std::array<Limits, 2*max_batch_size> limits;
+        for (std::size_t i = 0; i < batch_size; ++i)
+        {
+            const auto& [first, second] = parents[i].region().subdivide();
+            children[2*i] = first;
+            children[2*i + 1] = second;
+            limits[2*i] = first.limits();
+            limits[2*i + 1] = second.limits();
+        }
+
+        std::array<ResultType, 2*max_batch_size> results;
+        RuleType::integrate(f,
+                std::span<const Limits>(limits.data(), 2*batch_size),
+                std::span<ResultType>(results.data(), 2*batch_size));
+        m_region_eval_count += 2*batch_size;
+        for (std::size_t i = 0; i < batch_size; ++i)
+            m_func_eval_count
+                += 2*subdivision_points_count(parents[i].limits());
+
+        for (std::size_t i = 0; i < batch_size; ++i)
+        {
+            res += results[2*i];
+            res += results[2*i + 1];
+            res -= parents[i].result();
+            for (std::size_t k = 2*i; k < 2*i + 2; ++k)
+                push_to_heap(RegionType(
+                        children[k], results[k],
+                        RegionType::max_error(results[k])));
+        }
+    }
+
     [[nodiscard]] inline bool has_converged(
-        const ResultType& res, double abserr, double relerr) const noexcept
+        const ResultType& res, double abserr, double relerr)
     {
-        if constexpr (std::floating_point<CodomainType>)
-            return res.err <= abserr || res.err <= res.val*relerr;
+        if constexpr (componentwise)
+            return retire_converged_components(res, abserr, relerr);
         else
+            return is_converged<NormType>(res, abserr, relerr);
+    }
+
+    // Rules whose number of points depends on the region, such as 
+    // `DynamicGenzMalikD7`, take its limits as an argument.
+    [[nodiscard]] static constexpr std::size_t
+    points_count(const Limits& limits) noexcept
+    {
+        if constexpr (requires { RuleType::points_count(limits); })
+            return RuleType::points_count(limits);
+        else
+            return RuleType::points_count();
+    }
+
+    // Rules whose regions reuse function values of their parent report the
+    // number of new evaluations needed for a subregion.
+    [[nodiscard]] static constexpr std::size_t
+    subdivision_points_count(const Limits& parent_limits) noexcept
+    {
+        if constexpr (requires { RuleType::subdivision_points_count(); })
+            return RuleType::subdivision_points_count();
+        else
+            return points_count(parent_limits);
+    }
+
+    // Mark all components as active, and restore the priorities of the 
+    // regions if some were retired by a previous call to `refine`.
+    void activate_components(const ResultType& res)
+    {
+        const bool any_retired = std::ranges::any_of(m_component_status,
+            [](Status status){ return status == Status::SUCCESS; });
+        m_component_status.assign(res.ndim(), Status::MAX_SUBDIV);
+        if (any_retired)
+            m_regions.rekey([](const ResultType& result)
+            {
+                return RegionType::max_error(result);
+            });
+    }
+
+    // Retire the components which satisfy the tolerances, and update the 
+    // priorities of the regions if any were retired. Returns true if all
+    // components have been retired.
+    [[nodiscard]] bool retire_converged_components(
+        const ResultType& res, double abserr, double relerr)
+    {
+        bool retired_any = false;
+        bool all_retired = true;
+        for (std::size_t i = 0; i < res.ndim(); ++i)
         {
-            if constexpr (std::is_same_v<NormType, NormIndividual>)
+            if (m_component_status[i] == Status::SUCCESS) continue;
+            if (res.err[i] <= abserr || res.err[i] <= std::fabs(res.val[i])*relerr)
             {
-                for (std::size_t i = 0; i < res.ndim(); ++i)
-                {
-                    if (res.err[i] > abserr
-                            && res.err[i] > std::fabs(res.val[i])*relerr)
-                        return false;
-                }
-                return true;
+                m_component_status[i] = Status::SUCCESS;
+                retired_any = true;
             }
             else
-            {
-                const double norm_val = NormType::norm(res.val);
-                const double norm_err = NormType::norm(res.err);
-
-                return norm_err <= abserr || norm_err <= norm_val*relerr;
-            }
+                all_retired = false;
         }
+
+        if (retired_any && !all_retired)
+            m_regions.rekey([this](const ResultType& result)
+            {
+                return active_max_error(result);
+            });
+        return all_retired;
     }
 
-    inline void push_to_heap(const RegionType& region)
+    [[nodiscard]] double active_max_error(const ResultType& result) const noexcept
     {
-        m_region_heap.push_back(region);
-        std::ranges::push_heap(m_region_heap);
+        double maxerr = 0.0;
+        for (std::size_t i = 0; i < result.ndim(); ++i)
+        {
+            if (m_component_status[i] != Status::SUCCESS)
+                maxerr = std::max(maxerr, double(result.err[i]));
+        }
+        return maxerr;
     }
 
-    [[nodiscard]] inline RegionType pop_top_region()
+    /*
+        Retire up to half of the stored regions, starting with the smallest 
+        errors, while the total error of all retired regions stays below half 
+        the tolerance. Returns false if no region could be retired.
+    */
+    [[nodiscard]] bool retire_negligible_regions(
+        const ResultType& res, double abserr, double relerr)
     {
-        std::ranges::pop_heap(m_region_heap);
-        RegionType top_region = m_region_heap.back();
-        m_region_heap.pop_back();
-        return top_region;
+        // A pass which frees only a few slots would be repeated after as many
+        // subdivisions, and each pass sorts all regions. Requiring a fixed 
+        // fraction keeps the cost of retiring amortized over the iterations.
+        constexpr double budget_fraction = 0.5;
+        constexpr std::size_t min_count_divisor = 8;
+        const double budget = budget_fraction
+                *error_tolerance<NormType>(res, abserr, relerr)
+            - m_retired_maxerr;
+        const std::size_t min_count
+            = std::max<std::size_t>(m_regions.size()/min_count_divisor, 1);
+        const auto [count, maxerr_sum] = m_regions.retire_smallest(
+                min_count, m_regions.size()/2, budget, m_retired_result);
+        m_retired_maxerr += maxerr_sum;
+        m_retired_region_count += count;
+        return count > 0;
     }
 
-    template <typename LimitsRange>
-        requires SizedRangeOf<LimitsRange, Limits>
-    void generate_region_heap(LimitsRange&& limits)
+    inline void push_to_heap(const RegionType& region)
     {
-        m_region_heap.clear();
-        m_region_heap.reserve(std::ranges::size(limits));
-        for (const auto& limit : limits)
-            m_region_heap.emplace_back(limit);
+        if constexpr (componentwise)
+            m_regions.push(region, active_max_error(region.result()));
+        else
+            m_regions.push(region);
     }
 
-    void generate_region_heap(const Limits& limits)
+    [[nodiscard]] inline RegionType pop_top_region()
     {
-        m_region_heap.clear();
-        m_region_heap.reserve(1);
-        m_region_heap.emplace_back(limits);
+        return m_regions.pop();
     }
 
 private:
-    std::vector<RegionType> m_region_heap;
+    static constexpr bool componentwise
+        = std::same_as<NormType, NormComponentwise>
+            && !std::floating_point<CodomainType>;
+
+    RegionStoreType m_regions;
+    std::vector<RegionType> m_batch;
+    std::vector<std::pair<RegionType, RegionType>> m_batch_children;
+    std::shared_ptr<ThreadPool> m_thread_pool;
+    double m_batch_fraction = 0.5;
+    ResultType m_result{};
+    ResultType m_retired_result{};
+    double m_retired_maxerr = 0.0;
+    std::size_t m_retired_region_count{};
+    std::size_t m_max_regions = std::numeric_limits<std::size_t>::max();
     std::size_t m_region_eval_count{};
+    std::size_t m_func_eval_count{};
+    std::vector<Status> m_component_status;
 };
 
+
+namespace pmr
+{
+
+template <
+    typename RuleType, typename NormType = NormIndividual,
+    RegionQueue QueueType = BinaryHeapQueue>
+using MultiIntegrator = cubage::MultiIntegrator<
+    RuleType, NormType, QueueType, std::pmr::polymorphic_allocator<std::byte>>;
+
+}
+
 }
\ No newline at end of file
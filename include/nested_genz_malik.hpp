@@ -0,0 +1,356 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "box_region.hpp"
+#include "genz_malik.hpp"
+
+namespace cubage
+{
+
+/*
+    Fully symmetric rule of degree 7 with the same structure as `GenzMalikD7`,
+    i.e., the center, two one-variable point sets, a two-variable point set
+    and the vertices of a cube, but with the generators of the second
+    one-variable and the two-variable point sets placed on the faces of the
+    box. The remaining generators and the weights follow from the moment
+    equations of degree 7, and of degree 5 for the embedded rule used for the
+    error estimate, as in
+
+        A. C. Genz, A. A. Malik, "Remarks on algorithm 006 : An adaptive 
+        algorithm for numerical integration Over an N-dimensional rectangular 
+        region", J. Comput. Appl. Math. 6:295-302, 1980
+
+    The generators of `GenzMalikD7` are such that none of its points coincide 
+    with the points of the rule on either half of a bisected box. With points
+    on the faces instead, the half of the box on side `s` of axis `k` shares
+    the following points with the whole box: its face point on the inner face
+    along `k` is the center of the whole box, its face point on the outer face
+    is a face point of the whole box, and its two-variable points on the faces
+    normal to `k` are face points or two-variable points of the whole box. 
+    This saves `4*n - 2` of the `2^n + 2*n^2 + 2*n + 1` function evaluations 
+    for each half, where `n` is the dimension.
+
+    Since points lie on the boundary of the box, the integrand must be finite 
+    on the closed domain of integration.
+*/
+template <GenzMalikIntegrable DomainTypeParam, typename CodomainTypeParam>
+    requires std::floating_point<CodomainTypeParam>
+        || (FloatingPointVectorOperable<CodomainTypeParam>
+            && ArrayLike<CodomainTypeParam>)
+struct NestedGenzMalikD7
+{
+private:
+    static constexpr std::size_t ndim = std::tuple_size<DomainTypeParam>::value;
+
+public:
+    using DomainType = DomainTypeParam;
+    using CodomainType = CodomainTypeParam;
+    using ReturnType = std::pair<IntegralResult<CodomainType>, std::size_t>;
+    using Limits = Box<DomainType>;
+
+    /*
+        Function values passed from a box to its halves: the center, the face
+        points `c +/- h_i e_i` for each axis `i` (plus before minus), and the
+        two-variable points `c +/- h_k e_k +/- h_j e_j` for the subdivision 
+        axis `k` and each axis `j != k` in increasing order, with sign 
+        combinations `++, +-, -+, --` for `k` and `j`.
+    */
+    using NodeValues = std::array<CodomainType, 6*ndim - 3>;
+    using RegionType = NestedSubdivisibleBox<
+            DomainType, CodomainType, 6*ndim - 3>;
+
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(FuncType f, const Limits& limits)
+    {
+        NodeValues values{};
+        return integrate(f, limits, values, 0, 0);
+    }
+
+    /*
+        Integrate using the function values stored in `values`. If 
+        `parent_side` is nonzero, `values` contains the function values of the
+        parent box, which was subdivided along `parent_axis`, and the box is 
+        its lower (-1) or upper (+1) half. Otherwise all values are evaluated.
+        On return, `values` contains the function values needed by the halves
+        of this box.
+    */
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(
+        FuncType f, const Limits& limits, NodeValues& values,
+        std::size_t parent_axis, int parent_side)
+    {
+        const DomainType center = limits.center();
+        const DomainType half_lengths
+            = DomainValueType(0.5)*limits.side_lengths();
+
+        const bool reuse = parent_side != 0;
+        const std::size_t parent_sign = (parent_side > 0) ? 0 : 1;
+
+        DomainType point = center;
+        const CodomainType central_value = f(point);
+
+        // points c +/- gm_point_0*h_i e_i
+        std::array<CodomainType, ndim> second_diff_2;
+        CodomainType gm_sum_2{};
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            const DomainValueType disp
+                = DomainValueType(gm_point_0)*half_lengths[i];
+
+            point[i] = center[i] + disp;
+            const CodomainType fval_plus = f(point);
+            point[i] = center[i] - disp;
+            const CodomainType fval_minus = f(point);
+            point[i] = center[i];
+
+            gm_sum_2 += fval_plus;
+            gm_sum_2 += fval_minus;
+            second_diff_2[i] = (-2.0)*central_value;
+            second_diff_2[i] += fval_plus;
+            second_diff_2[i] += fval_minus;
+        }
+
+        // face points c +/- h_i e_i
+        std::array<CodomainType, 2*ndim> face_values;
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            for (std::size_t sign = 0; sign < 2; ++sign)
+            {
+                if (reuse && i == parent_axis)
+                {
+                    face_values[2*i + sign] = (sign == parent_sign) ?
+                        values[face_index(i, sign)] : values[0];
+                    continue;
+                }
+                point[i] = center[i] + signs[sign]*half_lengths[i];
+                face_values[2*i + sign] = f(point);
+            }
+            point[i] = center[i];
+        }
+
+        // two-variable points c +/- h_i e_i +/- h_j e_j for i < j
+        std::array<CodomainType, 2*ndim*(ndim - 1)> pair_values;
+        for (std::size_t i = 0, pair = 0; i < ndim; ++i)
+        {
+            for (std::size_t j = i + 1; j < ndim; ++j, ++pair)
+            {
+                for (std::size_t sign_i = 0; sign_i < 2; ++sign_i)
+                {
+                    for (std::size_t sign_j = 0; sign_j < 2; ++sign_j)
+                    {
+                        CodomainType& value
+                            = pair_values[4*pair + 2*sign_i + sign_j];
+                        if (reuse && (i == parent_axis || j == parent_axis))
+                        {
+                            const bool i_is_axis = i == parent_axis;
+                            const std::size_t other = i_is_axis ? j : i;
+                            const std::size_t axis_sign = i_is_axis ? sign_i : sign_j;
+                            const std::size_t other_sign = i_is_axis ? sign_j : sign_i;
+                            value = (axis_sign == parent_sign) ?
+                                values[pair_index(parent_axis, other, axis_sign, other_sign)]
+                                : values[face_index(other, other_sign)];
+                            continue;
+                        }
+                        point[i] = center[i] + signs[sign_i]*half_lengths[i];
+                        point[j] = center[j] + signs[sign_j]*half_lengths[j];
+                        value = f(point);
+                    }
+                }
+                point[i] = center[i];
+                point[j] = center[j];
+            }
+        }
+
+        std::array<CodomainType, ndim> second_diff_3;
+        CodomainType gm_sum_3{};
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            gm_sum_3 += face_values[2*i];
+            gm_sum_3 += face_values[2*i + 1];
+            second_diff_3[i] = (-2.0)*central_value;
+            second_diff_3[i] += face_values[2*i];
+            second_diff_3[i] += face_values[2*i + 1];
+        }
+
+        CodomainType gm_sum_4{};
+        for (const auto& value : pair_values)
+            gm_sum_4 += value;
+
+        const CodomainType gm_sum_5 = vertex_sum(f, center, half_lengths);
+
+        const auto& [result, axis] = rule_result(
+                limits.volume(),
+                {central_value, gm_sum_2, gm_sum_3, gm_sum_4, gm_sum_5},
+                second_diff_2, second_diff_3);
+
+        values[0] = central_value;
+        for (std::size_t i = 0; i < 2*ndim; ++i)
+            values[1 + i] = face_values[i];
+        for (std::size_t i = 0, pair = 0; i < ndim; ++i)
+        {
+            for (std::size_t j = i + 1; j < ndim; ++j, ++pair)
+            {
+                if (i != axis && j != axis) continue;
+                const bool i_is_axis = i == axis;
+                const std::size_t other = i_is_axis ? j : i;
+                for (std::size_t sign_i = 0; sign_i < 2; ++sign_i)
+                {
+                    for (std::size_t sign_j = 0; sign_j < 2; ++sign_j)
+                    {
+                        const std::size_t axis_sign = i_is_axis ? sign_i : sign_j;
+                        const std::size_t other_sign = i_is_axis ? sign_j : sign_i;
+                        values[pair_index(axis, other, axis_sign, other_sign)]
+                            = pair_values[4*pair + 2*sign_i + sign_j];
+                    }
+                }
+            }
+        }
+
+        return {result, axis};
+    }
+
+    [[nodiscard]] static constexpr std::size_t points_count() noexcept
+    {
+        return (std::size_t(1) << ndim) + 1 + 2*ndim*(1 + ndim);
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    subdivision_points_count() noexcept
+    {
+        return points_count() - (4*ndim - 2);
+    }
+
+private:
+    // The evaluation points are computed in the precision of the domain, 
+    // as in `GenzMalikD7`.
+    using DomainValueType = typename DomainType::value_type;
+
+    // sqrt(5/14) and sqrt(5/11); the other generators are 1
+    static constexpr double gm_point_0
+        = 0.597614304667196819984408589846562492423;
+    static constexpr double gm_point_2
+        = 0.674199862463242086246490676436428460089;
+    static constexpr std::array<DomainValueType, 2> signs = {1.0, -1.0};
+
+    using DiffType = std::array<CodomainType, ndim>;
+
+    [[nodiscard]] static constexpr std::size_t
+    face_index(std::size_t axis, std::size_t sign) noexcept
+    {
+        return 1 + 2*axis + sign;
+    }
+
+    [[nodiscard]] static constexpr std::size_t pair_index(
+        std::size_t axis, std::size_t other, std::size_t axis_sign,
+        std::size_t other_sign) noexcept
+    {
+        const std::size_t other_index = (other < axis) ? other : other - 1;
+        return 1 + 2*ndim + 4*other_index + 2*axis_sign + other_sign;
+    }
+
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr CodomainType vertex_sum(
+        FuncType f, const DomainType& center,
+        const DomainType& half_lengths)
+    {
+        const DomainType disp = DomainValueType(gm_point_2)*half_lengths;
+        DomainType point = center + disp;
+
+        CodomainType val = f(point);
+        std::uint64_t gray = 0;
+        for (std::uint64_t i = 1; i < (std::uint64_t(1) << ndim); ++i)
+        {
+            const std::size_t dim = std::size_t(std::countr_zero(i));
+            const std::uint64_t flipped_bit = std::uint64_t(1) << dim;
+            gray ^= flipped_bit;
+            point[dim] = (gray & flipped_bit) ?
+                    center[dim] - disp[dim] : center[dim] + disp[dim];
+            
+            val += f(point);
+        }
+
+        return val;
+    }
+
+    [[nodiscard]] static constexpr ReturnType rule_result(
+        double volume, const std::array<CodomainType, 5>& gm_sums,
+        const DiffType& second_diff_2, const DiffType& second_diff_3) noexcept
+    {
+        constexpr double n = double(ndim);
+        constexpr double v = double(std::uint64_t(1) << ndim);
+        constexpr std::array<double, 5> gm_weights_d7 = {
+            ((50.0/3375.0)*n + (-906.0/3375.0))*n + (2044.0/3375.0),
+            2352.0/30375.0,
+            (-2.0/135.0)*n + (4.0/81.0 + 2.0/135.0),
+            1.0/135.0,
+            (1331.0/3375.0)/v
+        };
+
+        constexpr std::array<double, 4> gm_weights_d5 = {
+            ((1.0/18.0)*n + (-1.0/18.0 - 53.0/75.0))*n + 1.0,
+            196.0/675.0,
+            (-1.0/18.0)*n + (17.0/270.0 + 1.0/18.0),
+            1.0/36.0
+        };
+
+        const CodomainType val = weighted_sum(volume, gm_weights_d7, gm_sums);
+        const CodomainType test_val = weighted_sum(volume, gm_weights_d5, gm_sums);
+
+        CodomainType err = val - test_val;
+        if constexpr (std::is_floating_point<CodomainType>::value)
+            err = std::fabs(err);
+        else
+            std::ranges::transform(
+                    err, err.begin(), static_cast<double(*)(double)>(std::fabs));
+
+        // The fourth difference eliminates the second derivative from the 
+        // second differences at the two one-variable generators.
+        constexpr double ratio = gm_point_0*gm_point_0;
+        std::size_t subdiv_axis = 0;
+        double max_fourth_diff = -1.0;
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            const double fourth_diff
+                = l1_norm(second_diff_2[i] - ratio*second_diff_3[i]);
+            if (fourth_diff > max_fourth_diff)
+            {
+                max_fourth_diff = fourth_diff;
+                subdiv_axis = i;
+            }
+        }
+
+        return {IntegralResult<CodomainType>{val, err}, subdiv_axis};
+    }
+};
+
+}
\ No newline at end of file
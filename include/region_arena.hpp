@@ -0,0 +1,310 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <span>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+#include "checkpoint.hpp"
+
+namespace cubage
+{
+
+/*
+    Growable array of regions, which allocates its elements in fixed-size 
+    chunks. Unlike `std::vector`, growing the arena never moves existing 
+    elements, so references to them stay valid, the peak memory is the working
+    set plus at most one partially filled chunk, and no time is spent copying
+    large regions during long runs.
+
+    Memory is obtained from `Allocator`. With a `std::pmr::polymorphic_allocator`,
+    several arenas, e.g., those of many integrators, can draw their chunks from
+    a shared `std::pmr::memory_resource` such as a pool. Chunks are kept by 
+    `clear` and only returned to the allocator on destruction, so an arena 
+    that is reused for many integrations allocates only during the first.
+*/
+template <
+    typename T, typename Allocator = std::allocator<T>,
+    std::size_t ChunkBytes = std::size_t(1) << 16>
+class RegionArena
+{
+    using ElementAllocator = typename std::allocator_traits<Allocator>
+        ::template rebind_alloc<T>;
+    using AllocatorTraits = std::allocator_traits<ElementAllocator>;
+    using ChunkAllocator = typename AllocatorTraits::template rebind_alloc<T*>;
+
+public:
+    using value_type = T;
+    using allocator_type = ElementAllocator;
+    using size_type = std::size_t;
+
+    // Number of elements per chunk, rounded down to a power of two so that 
+    // element lookup is a shift and a mask.
+    static constexpr std::size_t chunk_size
+        = std::bit_floor(std::max<std::size_t>(1, ChunkBytes/sizeof(T)));
+
+    template <bool IsConst>
+    class Iterator
+    {
+    public:
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using iterator_category = std::forward_iterator_tag;
+
+        Iterator() = default;
+
+        [[nodiscard]] reference operator*() const noexcept
+        {
+            return (*m_arena)[m_index];
+        }
+
+        [[nodiscard]] pointer operator->() const noexcept
+        {
+            return &(*m_arena)[m_index];
+        }
+
+        Iterator& operator++() noexcept
+        {
+            ++m_index;
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept
+        {
+            Iterator res = *this;
+            ++m_index;
+            return res;
+        }
+
+        [[nodiscard]] bool operator==(const Iterator&) const noexcept = default;
+
+    private:
+        using ArenaPointer = std::conditional_t<
+                IsConst, const RegionArena*, RegionArena*>;
+
+        friend class RegionArena;
+        Iterator(ArenaPointer arena, std::size_t index) noexcept:
+            m_arena(arena), m_index(index) {}
+
+        ArenaPointer m_arena{};
+        std::size_t m_index{};
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    RegionArena() = default;
+
+    explicit RegionArena(const Allocator& alloc):
+        m_alloc(alloc), m_chunks(ChunkAllocator(alloc)) {}
+
+    RegionArena(const RegionArena& other):
+        m_alloc(AllocatorTraits::select_on_container_copy_construction(
+                other.m_alloc)),
+        m_chunks(ChunkAllocator(m_alloc))
+    {
+        copy_elements(other);
+    }
+
+    // The elements are copied into chunks from the allocator of this arena.
+    RegionArena& operator=(const RegionArena& other)
+    {
+        if (this == &other) return *this;
+        clear();
+        copy_elements(other);
+        return *this;
+    }
+
+    RegionArena(RegionArena&& other) noexcept:
+        m_alloc(other.m_alloc), m_chunks(std::move(other.m_chunks)),
+        m_size(std::exchange(other.m_size, 0))
+    {
+        other.m_chunks.clear();
+    }
+
+    // Chunks can only be taken over from an arena with an equal allocator,
+    // otherwise the elements are copied.
+    RegionArena& operator=(RegionArena&& other)
+    {
+        if (this == &other) return *this;
+
+        release();
+        if (m_alloc == other.m_alloc)
+        {
+            m_chunks = std::move(other.m_chunks);
+            other.m_chunks.clear();
+            m_size = std::exchange(other.m_size, 0);
+        }
+        else
+        {
+            copy_elements(other);
+            other.release();
+        }
+        return *this;
+    }
+
+    ~RegionArena() { release(); }
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return m_alloc;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_chunks.size()*chunk_size;
+    }
+
+    [[nodiscard]] T& operator[](std::size_t i) noexcept
+    {
+        return m_chunks[i/chunk_size][i % chunk_size];
+    }
+
+    [[nodiscard]] const T& operator[](std::size_t i) const noexcept
+    {
+        return m_chunks[i/chunk_size][i % chunk_size];
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+    [[nodiscard]] iterator end() noexcept { return iterator(this, m_size); }
+
+    [[nodiscard]] const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept
+    {
+        return const_iterator(this, m_size);
+    }
+
+    void reserve(std::size_t count)
+    {
+        while (capacity() < count)
+            m_chunks.push_back(AllocatorTraits::allocate(m_alloc, chunk_size));
+    }
+
+    void push_back(const T& value)
+    {
+        reserve(m_size + 1);
+        AllocatorTraits::construct(m_alloc, &(*this)[m_size], value);
+        ++m_size;
+    }
+
+    void resize(std::size_t count)
+    {
+        reserve(count);
+        for (; m_size < count; ++m_size)
+            AllocatorTraits::construct(m_alloc, &(*this)[m_size]);
+        for (; m_size > count; --m_size)
+            AllocatorTraits::destroy(m_alloc, &(*this)[m_size - 1]);
+    }
+
+    // Destroy all elements, but keep the chunks for reuse.
+    void clear() noexcept { resize(0); }
+
+    /*
+        Call `f` with a span of the elements of each chunk in order. The spans
+        together cover all elements of the arena.
+    */
+    template <typename FuncType>
+    void for_each_chunk(FuncType f) const
+    {
+        for (std::size_t first = 0; first < m_size; first += chunk_size)
+            f(std::span<const T>(
+                    &(*this)[first], std::min(chunk_size, m_size - first)));
+    }
+
+    template <typename FuncType>
+    void for_each_chunk(FuncType f)
+    {
+        for (std::size_t first = 0; first < m_size; first += chunk_size)
+            f(std::span<T>(
+                    &(*this)[first], std::min(chunk_size, m_size - first)));
+    }
+
+    // Destroy all elements and return the chunks to the allocator.
+    void release() noexcept
+    {
+        clear();
+        for (T* chunk : m_chunks)
+            AllocatorTraits::deallocate(m_alloc, chunk, chunk_size);
+        m_chunks.clear();
+    }
+
+private:
+    void copy_elements(const RegionArena& other)
+    {
+        reserve(other.size());
+        for (const T& value : other)
+            push_back(value);
+    }
+
+    [[no_unique_address]] ElementAllocator m_alloc{};
+    std::vector<T*, ChunkAllocator> m_chunks{ChunkAllocator(m_alloc)};
+    std::size_t m_size{};
+};
+
+/*
+    Checkpoint I/O of arenas, which uses the same format as for `std::vector`.
+*/
+template <typename T, typename Allocator, std::size_t ChunkBytes>
+    requires std::is_trivially_copyable_v<T>
+void write_binary(
+    std::ostream& out, const RegionArena<T, Allocator, ChunkBytes>& values)
+{
+    write_binary(out, std::uint64_t(values.size()));
+    values.for_each_chunk([&](std::span<const T> chunk)
+    {
+        out.write(
+                reinterpret_cast<const char*>(chunk.data()),
+                std::streamsize(chunk.size()*sizeof(T)));
+    });
+}
+
+template <typename T, typename Allocator, std::size_t ChunkBytes>
+    requires std::is_trivially_copyable_v<T>
+void read_binary(std::istream& in, RegionArena<T, Allocator, ChunkBytes>& values)
+{
+    values.resize(read_element_count<T>(in));
+    values.for_each_chunk([&](std::span<T> chunk)
+    {
+        in.read(
+                reinterpret_cast<char*>(chunk.data()),
+                std::streamsize(chunk.size()*sizeof(T)));
+        if (!in)
+            throw std::runtime_error("invalid checkpoint: unexpected end of data");
+    });
+}
+
+}
\ No newline at end of file
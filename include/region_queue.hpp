@@ -0,0 +1,391 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <ranges>
+#include <compare>
+#include <cmath>
+#include <new>
+#include <limits>
+#include <concepts>
+
+namespace cubage
+{
+
+/*
+    Key of a region in the priority queue of a `RegionStore`. Keys are ordered
+    by error, and ties are broken by index, so that the order in which the 
+    exact queues return regions does not depend on their internal layout.
+*/
+struct RegionKey
+{
+    double maxerr;
+    std::size_t index;
+
+    constexpr auto operator<=>(const RegionKey& b) const noexcept = default;
+};
+
+template <typename QueueType>
+concept RegionQueue = requires (QueueType q, const QueueType cq, RegionKey key)
+{
+    q.clear();
+    q.reserve(std::size_t{});
+    q.push(key);
+    { q.pop() } -> std::same_as<RegionKey>;
+    { cq.top() } -> std::same_as<const RegionKey&>;
+    { cq.size() } -> std::same_as<std::size_t>;
+    { cq.empty() } -> std::same_as<bool>;
+};
+
+template <typename T, std::size_t Alignment>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    constexpr AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(
+                ::operator new(n*sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, [[maybe_unused]] std::size_t n) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    constexpr bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept
+    {
+        return true;
+    }
+};
+
+/*
+    Binary max-heap of region keys.
+*/
+class BinaryHeapQueue
+{
+public:
+    void clear() noexcept { m_keys.clear(); }
+
+    void reserve(std::size_t count) { m_keys.reserve(count); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_keys.size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_keys.empty(); }
+
+    [[nodiscard]] const RegionKey& top() const noexcept
+    {
+        return m_keys.front();
+    }
+
+    void push(const RegionKey& key)
+    {
+        m_keys.push_back(key);
+        std::ranges::push_heap(m_keys);
+    }
+
+    [[nodiscard]] RegionKey pop() noexcept
+    {
+        std::ranges::pop_heap(m_keys);
+        const RegionKey key = m_keys.back();
+        m_keys.pop_back();
+        return key;
+    }
+
+private:
+    std::vector<RegionKey> m_keys;
+};
+
+/*
+    4-ary max-heap of region keys. The heap is halved in depth compared to a
+    binary heap, and the storage is offset so that the four children of a node
+    always occupy a single 64 byte cache line.
+*/
+class QuaternaryHeapQueue
+{
+public:
+    void clear() noexcept { m_keys.resize(offset); }
+
+    void reserve(std::size_t count) { m_keys.reserve(count + offset); }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_keys.size() - offset;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] const RegionKey& top() const noexcept
+    {
+        return m_keys[offset];
+    }
+
+    void push(const RegionKey& key)
+    {
+        m_keys.push_back(key);
+        sift_up(m_keys.size() - 1);
+    }
+
+    [[nodiscard]] RegionKey pop() noexcept
+    {
+        const RegionKey key = m_keys[offset];
+        m_keys[offset] = m_keys.back();
+        m_keys.pop_back();
+        if (!empty())
+            sift_down(offset);
+        return key;
+    }
+
+private:
+    static constexpr std::size_t cache_line_size = 64;
+    static constexpr std::size_t arity = cache_line_size/sizeof(RegionKey);
+    static_assert(arity == 4);
+
+    // The root is placed at index `arity - 1`, so that the children of the
+    // node at index `i` start at the aligned index `arity*(i - arity + 2)`.
+    static constexpr std::size_t offset = arity - 1;
+
+    [[nodiscard]] static constexpr std::size_t
+    first_child(std::size_t i) noexcept { return arity*(i + 2 - arity); }
+
+    [[nodiscard]] static constexpr std::size_t
+    parent(std::size_t i) noexcept { return (i - arity)/arity + offset; }
+
+    void sift_up(std::size_t i) noexcept
+    {
+        const RegionKey key = m_keys[i];
+        while (i > offset)
+        {
+            const std::size_t p = parent(i);
+            if (!(m_keys[p] < key)) break;
+            m_keys[i] = m_keys[p];
+            i = p;
+        }
+        m_keys[i] = key;
+    }
+
+    void sift_down(std::size_t i) noexcept
+    {
+        const RegionKey key = m_keys[i];
+        const std::size_t end = m_keys.size();
+        while (true)
+        {
+            const std::size_t first = first_child(i);
+            if (first >= end) break;
+
+            const std::size_t last = std::min(first + arity, end);
+            std::size_t largest = first;
+            for (std::size_t c = first + 1; c < last; ++c)
+                if (m_keys[largest] < m_keys[c])
+                    largest = c;
+
+            if (!(key < m_keys[largest])) break;
+            m_keys[i] = m_keys[largest];
+            i = largest;
+        }
+        m_keys[i] = key;
+    }
+
+    std::vector<RegionKey, AlignedAllocator<RegionKey, cache_line_size>> m_keys
+        = std::vector<RegionKey, AlignedAllocator<RegionKey, cache_line_size>>(offset);
+};
+
+/*
+    Approximate priority queue of region keys, which sorts the keys into
+    buckets by the binary exponent of their error. Keys within the bucket of
+    the largest exponent are returned in last-in first-out order, so the
+    returned key is within a factor of two of the largest error.
+*/
+class BucketQueue
+{
+public:
+    void clear() noexcept
+    {
+        for (auto& bucket : m_buckets)
+            bucket.clear();
+        m_top = 0;
+        m_size = 0;
+    }
+
+    void reserve([[maybe_unused]] std::size_t count) {}
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] const RegionKey& top() const noexcept
+    {
+        return m_buckets[m_top].back();
+    }
+
+    void push(const RegionKey& key)
+    {
+        const std::size_t index = bucket_index(key.maxerr);
+        m_buckets[index].push_back(key);
+        if (index > m_top || m_size == 0)
+            m_top = index;
+        ++m_size;
+    }
+
+    [[nodiscard]] RegionKey pop() noexcept
+    {
+        const RegionKey key = m_buckets[m_top].back();
+        m_buckets[m_top].pop_back();
+        --m_size;
+        while (m_top > 0 && m_buckets[m_top].empty())
+            --m_top;
+        return key;
+    }
+
+private:
+    // Zero and subnormal errors share the lowest bucket, and infinities and
+    // NaNs share the highest bucket.
+    static constexpr int min_exponent = std::numeric_limits<double>::min_exponent - 1;
+    static constexpr int max_exponent = std::numeric_limits<double>::max_exponent - 1;
+    static constexpr std::size_t bucket_count
+        = std::size_t(max_exponent - min_exponent) + 3;
+
+    [[nodiscard]] static std::size_t bucket_index(double maxerr) noexcept
+    {
+        if (!(maxerr < std::numeric_limits<double>::infinity()))
+            return bucket_count - 1;
+        if (maxerr < std::numeric_limits<double>::min())
+            return 0;
+        return std::size_t(std::ilogb(maxerr) - min_exponent) + 1;
+    }
+
+    std::vector<std::vector<RegionKey>> m_buckets
+        = std::vector<std::vector<RegionKey>>(bucket_count);
+    std::size_t m_top{};
+    std::size_t m_size{};
+};
+
+/*
+    Priority queue of region keys, which defers ordering of newly pushed keys.
+    New keys are collected into an unsorted buffer, which is sorted into a new
+    run once `Interval` keys have been pushed, or when no other keys are left.
+    Runs are merged like the digits of a binary counter, so there are about
+    `log2(size()/Interval)` runs, and each key takes part in as many merges. 
+    `pop` returns the largest key at the ends of the runs, so the keys in the
+    buffer are only ordered once they have been sorted into a run.
+*/
+template <std::size_t Interval = 64>
+    requires (Interval > 0)
+class LazySortQueue
+{
+public:
+    void clear() noexcept
+    {
+        m_runs.clear();
+        m_pending.clear();
+        m_size = 0;
+    }
+
+    void reserve(std::size_t count)
+    {
+        m_pending.reserve(Interval);
+        m_merged.reserve(count);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+    [[nodiscard]] const RegionKey& top() const noexcept
+    {
+        return m_runs[m_top_run].back();
+    }
+
+    void push(const RegionKey& key)
+    {
+        m_pending.push_back(key);
+        ++m_size;
+        if (m_pending.size() >= Interval || m_runs.empty())
+            sort_pending();
+    }
+
+    [[nodiscard]] RegionKey pop()
+    {
+        std::vector<RegionKey>& run = m_runs[m_top_run];
+        const RegionKey key = run.back();
+        run.pop_back();
+        --m_size;
+        if (run.empty())
+            m_runs.erase(m_runs.begin() + std::ptrdiff_t(m_top_run));
+
+        if (m_runs.empty() && !m_pending.empty())
+            sort_pending();
+        else
+            find_top_run();
+        return key;
+    }
+
+private:
+    // Sort the buffer into a new run, and merge the last two runs while the 
+    // last is at least as long as the one before it.
+    void sort_pending()
+    {
+        std::ranges::sort(m_pending);
+        m_runs.push_back(m_pending);
+        m_pending.clear();
+
+        while (m_runs.size() >= 2
+                && m_runs[m_runs.size() - 2].size() <= m_runs.back().size())
+        {
+            std::vector<RegionKey>& lower = m_runs[m_runs.size() - 2];
+            m_merged.resize(lower.size() + m_runs.back().size());
+            std::ranges::merge(lower, m_runs.back(), m_merged.begin());
+            std::swap(lower, m_merged);
+            m_runs.pop_back();
+        }
+        find_top_run();
+    }
+
+    void find_top_run() noexcept
+    {
+        m_top_run = 0;
+        for (std::size_t i = 1; i < m_runs.size(); ++i)
+        {
+            if (m_runs[m_top_run].back() < m_runs[i].back())
+                m_top_run = i;
+        }
+    }
+
+    std::vector<std::vector<RegionKey>> m_runs;
+    std::vector<RegionKey> m_pending;
+    std::vector<RegionKey> m_merged;
+    std::size_t m_top_run{};
+    std::size_t m_size{};
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <ranges>
+#include <concepts>
+#include <memory>
+#include <utility>
+
+#include "region_queue.hpp"
+#include "region_arena.hpp"
+#include "checkpoint.hpp"
+
+namespace cubage
+{
+
+/*
+    Storage for the regions of an adaptive integrator.
+
+    The regions are split into a structure of arrays: the subdivisible regions
+    (limits and any data the rule attaches to them) and the integration results
+    are stored in separate arrays, and a priority queue of small keys,
+    consisting of the error of the region and its index into the arrays,
+    determines the order in which the regions are subdivided. Queue operations
+    therefore only move the keys, no matter how large the regions are.
+
+    Slots freed by `pop` are reused by subsequent calls to `push`. The regions
+    and results are kept in `RegionArena`s with memory from `Allocator`, so 
+    growing the store never moves them.
+*/
+template <
+    typename Region, RegionQueue QueueType = BinaryHeapQueue,
+    typename Allocator = std::allocator<std::byte>>
+class RegionStore
+{
+public:
+    using RegionType = Region;
+    using SubregionType = typename Region::RegionType;
+    using ResultType = typename Region::Result;
+    using allocator_type = Allocator;
+    using SubregionArena = RegionArena<SubregionType, Allocator>;
+    using ResultArena = RegionArena<ResultType, Allocator>;
+
+    RegionStore() = default;
+
+    explicit RegionStore(const Allocator& alloc):
+        m_regions(alloc), m_results(alloc) {}
+
+    [[nodiscard]] allocator_type get_allocator() const noexcept
+    {
+        return m_regions.get_allocator();
+    }
+
+    void clear() noexcept
+    {
+        m_queue.clear();
+        m_regions.clear();
+        m_results.clear();
+        m_free_slots.clear();
+    }
+
+    void reserve(std::size_t count)
+    {
+        m_queue.reserve(count);
+        m_regions.reserve(count);
+        m_results.reserve(count);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return m_queue.size(); }
+
+    [[nodiscard]] bool empty() const noexcept { return m_queue.empty(); }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_regions.capacity();
+    }
+
+    [[nodiscard]] double top_maxerr() const noexcept
+    {
+        return m_queue.top().maxerr;
+    }
+
+    void push(const RegionType& region)
+    {
+        push(region, region.maxerr());
+    }
+
+    // Push a region with a priority `maxerr` other than its own error.
+    void push(const RegionType& region, double maxerr)
+    {
+        std::size_t index;
+        if (m_free_slots.empty())
+        {
+            index = m_regions.size();
+            m_regions.push_back(region.region());
+            m_results.push_back(region.result());
+        }
+        else
+        {
+            index = m_free_slots.back();
+            m_free_slots.pop_back();
+            m_regions[index] = region.region();
+            m_results[index] = region.result();
+        }
+
+        m_queue.push(RegionKey{maxerr, index});
+    }
+
+    [[nodiscard]] RegionType pop()
+    {
+        const RegionKey key = m_queue.pop();
+        m_free_slots.push_back(key.index);
+        return RegionType(m_regions[key.index], m_results[key.index], key.maxerr);
+    }
+
+    /*
+        Subdivisible regions and their results. Slots released by `pop` remain
+        in these arenas until reused by `push`.
+    */
+    [[nodiscard]] const SubregionArena& regions() const noexcept
+    {
+        return m_regions;
+    }
+
+    [[nodiscard]] const ResultArena& results() const noexcept
+    {
+        return m_results;
+    }
+
+    /*
+        Remove up to `max_count` regions with the smallest priorities, as long
+        as the sum of their priorities does not exceed `max_priority_sum`, and
+        add their results to `retired`. If fewer than `min_count` regions can 
+        be removed, none are. The remaining regions are compacted into the 
+        leading slots, so no slots are left free. Returns the number of 
+        removed regions and the sum of their priorities.
+    */
+    std::pair<std::size_t, double> retire_smallest(
+        std::size_t min_count, std::size_t max_count, double max_priority_sum,
+        ResultType& retired)
+    {
+        std::vector<RegionKey> keys;
+        keys.reserve(m_queue.size());
+        while (!m_queue.empty())
+            keys.push_back(m_queue.pop());
+        std::ranges::sort(keys);
+
+        std::size_t count = 0;
+        double priority_sum = 0.0;
+        max_count = std::min(max_count, keys.size());
+        while (count < max_count
+                && priority_sum + keys[count].maxerr <= max_priority_sum)
+        {
+            priority_sum += keys[count].maxerr;
+            ++count;
+        }
+
+        if (count < min_count)
+        {
+            count = 0;
+            priority_sum = 0.0;
+        }
+
+        for (std::size_t i = 0; i < count; ++i)
+            retired += m_results[keys[i].index];
+
+        // Move the remaining regions stored beyond the new size into the 
+        // holes below it, of which there are exactly as many.
+        const std::size_t live_count = keys.size() - count;
+        std::vector<bool> is_live(m_regions.size());
+        for (std::size_t i = count; i < keys.size(); ++i)
+            is_live[keys[i].index] = true;
+
+        std::size_t hole = 0;
+        for (std::size_t i = count; i < keys.size(); ++i)
+        {
+            if (keys[i].index < live_count) continue;
+            while (is_live[hole]) ++hole;
+            m_regions[hole] = m_regions[keys[i].index];
+            m_results[hole] = m_results[keys[i].index];
+            keys[i].index = hole++;
+        }
+
+        m_regions.resize(live_count);
+        m_results.resize(live_count);
+        m_free_slots.clear();
+        m_queue.reserve(live_count);
+        for (std::size_t i = count; i < keys.size(); ++i)
+            m_queue.push(keys[i]);
+
+        return {count, priority_sum};
+    }
+
+    void save(std::ostream& out) const
+    {
+        write_checkpoint_header<RegionType>(out);
+        write_binary(out, m_regions);
+        write_binary(out, m_results);
+        write_binary(out, m_free_slots);
+    }
+
+    /*
+        Restore the regions from a checkpoint written by `save`. The queue is 
+        rebuilt from the stored results, so no integrand evaluations are 
+        needed.
+    */
+    void load(std::istream& in)
+    {
+        clear();
+        read_checkpoint_header<RegionType>(in);
+        read_binary(in, m_regions);
+        read_binary(in, m_results);
+        read_binary(in, m_free_slots);
+        if (m_results.size() != m_regions.size())
+            throw std::runtime_error("invalid checkpoint: inconsistent sizes");
+
+        for (const std::size_t slot : m_free_slots)
+        {
+            if (slot >= m_regions.size())
+                throw std::runtime_error("invalid checkpoint: bad free slot");
+        }
+
+        rekey([](const ResultType& result)
+        {
+            return RegionType::max_error(result);
+        });
+    }
+
+    /*
+        Rebuild the queue with the priority of each region given by 
+        `max_error(result)`.
+    */
+    template <typename ErrorFuncType>
+        requires std::invocable<ErrorFuncType, const ResultType&>
+    void rekey(ErrorFuncType max_error)
+    {
+        std::vector<bool> is_free(m_regions.size());
+        for (const std::size_t slot : m_free_slots)
+            is_free[slot] = true;
+
+        m_queue.clear();
+        m_queue.reserve(m_regions.size());
+        for (std::size_t i = 0; i < m_regions.size(); ++i)
+        {
+            if (!is_free[i])
+                m_queue.push(RegionKey{max_error(m_results[i]), i});
+        }
+    }
+
+private:
+    QueueType m_queue;
+    SubregionArena m_regions;
+    ResultArena m_results;
+    std::vector<std::size_t> m_free_slots;
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <cmath>
+#include <array>
+#include <ranges>
+#include <algorithm>
+
+#include "integral_result.hpp"
+#include "interval_region.hpp"
+
+namespace cubage
+{
+
+/*
+    Romberg rule based on 
+
+        Werner Romberg, "Vereinfachte numerische Integration", Det Kongelige 
+        Norske Videnskabers Selskab Forhandlinger 28:30-36, 1955
+    
+    This rule evaluates the function at `2^Levels + 1` equally spaced nodes, 
+    including the endpoints, and applies Richardson extrapolation to the 
+    trapezoidal rules on the nested subsets of the nodes. The result is exact 
+    for polynomials of degree `2*Levels + 1`. The error is estimated by 
+    comparing to the extrapolation of one level lower, which uses every other 
+    node. Since the endpoints are nodes, the integrand must be finite at both
+    ends of the interval; integrable endpoint singularities need a rule with 
+    interior nodes only, such as `GaussKronrod`. The tableau is computed in 
+    the precision of the components of the codomain.
+
+    Unlike the Gauss-Kronrod rules, whose nodes never coincide with the nodes 
+    of the rule on either half of the interval, the nodes of this rule are 
+    nested under bisection. Therefore, when used with an adaptive integrator, 
+    the halves of a subdivided interval reuse half of their function values 
+    from the parent, and each subdivision costs only `2^Levels` new function 
+    evaluations in total. This makes this rule a good fit for expensive 
+    integrands of moderate smoothness.
+*/
+template <std::floating_point DomainTypeParam, typename CodomainTypeParam, std::size_t Levels = 4>
+    requires (Levels > 0 && Levels < 16)
+    && (std::floating_point<CodomainTypeParam>
+        || (FloatingPointVectorOperable<CodomainTypeParam>
+            && ArrayLike<CodomainTypeParam>))
+struct Romberg
+{
+    using DomainType = DomainTypeParam;
+    using CodomainType = CodomainTypeParam;
+    using ReturnType = IntegralResult<CodomainType>;
+    using Real = real_component_t<CodomainType>;
+    using Limits = Interval<DomainType>;
+    using NodeValues = std::array<CodomainType, (1UL << Levels) + 1>;
+    using RegionType = NestedSubdivisibleInterval<
+            DomainType, CodomainType, (1UL << Levels) + 1>;
+
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(FuncType f, const Limits& limits)
+    {
+        NodeValues values{};
+        return integrate(f, limits, values, false);
+    }
+
+    /*
+        Integrate using the function values stored in `values`. If 
+        `reuse_even_nodes` is true, the values at the nodes with even index are 
+        assumed to be known, and only the values at the nodes with odd index are
+        evaluated. Otherwise all values are evaluated. On return, `values` 
+        contains the function values at all nodes.
+    */
+    template <typename FuncType>
+        requires MapsAs<FuncType, DomainType, CodomainType>
+    [[nodiscard]] static constexpr ReturnType
+    integrate(
+        FuncType f, const Limits& limits, NodeValues& values,
+        bool reuse_even_nodes)
+    {
+        constexpr std::size_t node_count = (1UL << Levels) + 1;
+        const DomainType step = limits.length()/DomainType(node_count - 1);
+
+        const std::size_t stride = reuse_even_nodes ? 2 : 1;
+        const std::size_t first = reuse_even_nodes ? 1 : 0;
+        for (std::size_t i = first; i < node_count; i += stride)
+            values[i] = f(limits.xmin + DomainType(i)*step);
+
+        // Romberg tableau, where only the diagonal is kept
+        std::array<CodomainType, Levels + 1> row{};
+        std::array<CodomainType, Levels + 1> previous_row{};
+        const Real length = Real(limits.length());
+        CodomainType trapezoid
+            = (Real(0.5)*length)*(values[0] + values[node_count - 1]);
+        row[0] = trapezoid;
+        for (std::size_t k = 1; k <= Levels; ++k)
+        {
+            std::swap(row, previous_row);
+
+            const std::size_t node_stride = 1UL << (Levels - k);
+            CodomainType midpoint_sum{};
+            for (std::size_t i = node_stride; i < node_count; i += 2*node_stride)
+                midpoint_sum += values[i];
+            
+            const Real h = length/Real(1UL << k);
+            trapezoid = Real(0.5)*trapezoid + h*midpoint_sum;
+            row[0] = trapezoid;
+
+            Real factor = 1;
+            for (std::size_t j = 1; j <= k; ++j)
+            {
+                factor *= 4;
+                row[j] = row[j - 1] + (Real(1)/(factor - 1))*(row[j - 1] - previous_row[j - 1]);
+            }
+        }
+
+        CodomainType err = row[Levels] - previous_row[Levels - 1];
+        if constexpr (std::is_floating_point<CodomainType>::value)
+            err = std::fabs(err);
+        else
+            std::ranges::transform(
+                    err, err.begin(), static_cast<double(*)(double)>(std::fabs));
+
+        return IntegralResult<CodomainType>{row[Levels], err};
+    }
+
+    [[nodiscard]] static constexpr std::size_t points_count() noexcept
+    {
+        return (1UL << Levels) + 1;
+    }
+
+    [[nodiscard]] static constexpr std::size_t
+    subdivision_points_count() noexcept
+    {
+        return 1UL << (Levels - 1);
+    }
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,368 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <type_traits>
+
+#if defined(CUBAGE_SIMD) && defined(__x86_64__) \
+    && (defined(__GNUC__) || defined(__clang__))
+#define CUBAGE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/*
+    Optional SIMD kernels for the arithmetic of `std::array<double, N>` in
+    array_arithmetic.hpp and the reductions in `Box::volume` and `l1_norm`.
+
+    The kernels are enabled by defining `CUBAGE_SIMD`, e.g., with the CMake 
+    option `CUBAGE_ENABLE_SIMD`. On x86-64, the widest of the AVX-512, AVX2 
+    and scalar kernels supported by the CPU is then selected at runtime, so 
+    the binary does not need to be compiled for a specific instruction set. 
+    Only arrays of at least `min_dispatch_size` doubles are dispatched, since
+    for shorter arrays the indirect call costs more than the inlined loop. 
+    Constant evaluation always uses the plain loops.
+
+    The vectorized reductions sum in a different order than the plain loops,
+    so their results may differ in the last bits.
+*/
+namespace cubage::simd
+{
+
+enum class InstructionSet
+{
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+inline constexpr std::size_t min_dispatch_size = 16;
+
+#ifdef CUBAGE_SIMD
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+template <typename T>
+concept Dispatched = enabled
+    && std::same_as<T, std::array<double, std::tuple_size<T>::value>>
+    && std::tuple_size<T>::value >= min_dispatch_size;
+
+struct KernelTable
+{
+    InstructionSet instruction_set;
+    void (*add)(double* a, const double* b, std::size_t n) noexcept;
+    void (*subtract)(double* a, const double* b, std::size_t n) noexcept;
+    void (*multiply)(double* a, const double* b, std::size_t n) noexcept;
+    void (*scale)(double* a, double b, std::size_t n) noexcept;
+    double (*abs_sum)(const double* a, std::size_t n) noexcept;
+    double (*product)(const double* a, std::size_t n) noexcept;
+};
+
+namespace scalar
+{
+
+inline void add(double* a, const double* b, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] += b[i];
+}
+
+inline void subtract(double* a, const double* b, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] -= b[i];
+}
+
+inline void multiply(double* a, const double* b, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] *= b[i];
+}
+
+inline void scale(double* a, double b, std::size_t n) noexcept
+{
+    for (std::size_t i = 0; i < n; ++i)
+        a[i] *= b;
+}
+
+inline double abs_sum(const double* a, std::size_t n) noexcept
+{
+    double res = 0.0;
+    for (std::size_t i = 0; i < n; ++i)
+        res += std::fabs(a[i]);
+    return res;
+}
+
+inline double product(const double* a, std::size_t n) noexcept
+{
+    double res = 1.0;
+    for (std::size_t i = 0; i < n; ++i)
+        res *= a[i];
+    return res;
+}
+
+}
+
+#ifdef CUBAGE_SIMD_X86
+namespace avx2
+{
+
+__attribute__((target("avx2")))
+inline void add(double* a, const double* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_add_pd(
+                _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] += b[i];
+}
+
+__attribute__((target("avx2")))
+inline void subtract(double* a, const double* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_sub_pd(
+                _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] -= b[i];
+}
+
+__attribute__((target("avx2")))
+inline void multiply(double* a, const double* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_mul_pd(
+                _mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] *= b[i];
+}
+
+__attribute__((target("avx2")))
+inline void scale(double* a, double b, std::size_t n) noexcept
+{
+    const __m256d factor = _mm256_set1_pd(b);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(a + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), factor));
+    for (; i < n; ++i)
+        a[i] *= b;
+}
+
+__attribute__((target("avx2")))
+inline double horizontal_sum(__m256d x) noexcept
+{
+    const __m128d pair = _mm_add_pd(
+            _mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+__attribute__((target("avx2")))
+inline double horizontal_product(__m256d x) noexcept
+{
+    const __m128d pair = _mm_mul_pd(
+            _mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_mul_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+__attribute__((target("avx2")))
+inline double abs_sum(const double* a, std::size_t n) noexcept
+{
+    const __m256d sign_mask = _mm256_set1_pd(-0.0);
+    __m256d acc = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_add_pd(
+                acc, _mm256_andnot_pd(sign_mask, _mm256_loadu_pd(a + i)));
+    double res = horizontal_sum(acc);
+    for (; i < n; ++i)
+        res += std::fabs(a[i]);
+    return res;
+}
+
+__attribute__((target("avx2")))
+inline double product(const double* a, std::size_t n) noexcept
+{
+    __m256d acc = _mm256_set1_pd(1.0);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        acc = _mm256_mul_pd(acc, _mm256_loadu_pd(a + i));
+    double res = horizontal_product(acc);
+    for (; i < n; ++i)
+        res *= a[i];
+    return res;
+}
+
+}
+
+namespace avx512
+{
+
+__attribute__((target("avx512f")))
+inline void add(double* a, const double* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_add_pd(
+                _mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] += b[i];
+}
+
+__attribute__((target("avx512f")))
+inline void subtract(double* a, const double* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_sub_pd(
+                _mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] -= b[i];
+}
+
+__attribute__((target("avx512f")))
+inline void multiply(double* a, const double* b, std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_mul_pd(
+                _mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    for (; i < n; ++i)
+        a[i] *= b[i];
+}
+
+__attribute__((target("avx512f")))
+inline void scale(double* a, double b, std::size_t n) noexcept
+{
+    const __m512d factor = _mm512_set1_pd(b);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(a + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), factor));
+    for (; i < n; ++i)
+        a[i] *= b;
+}
+
+// The horizontal reductions go through memory, since GCC warns about 
+// uninitialized values in the expansions of `_mm512_reduce_add_pd`, 
+// `_mm512_reduce_mul_pd` and `_mm512_extractf64x4_pd` at `-O2 -Wall`.
+__attribute__((target("avx512f")))
+inline double horizontal_sum(__m512d x) noexcept
+{
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, x);
+    return ((lanes[0] + lanes[4]) + (lanes[2] + lanes[6]))
+        + ((lanes[1] + lanes[5]) + (lanes[3] + lanes[7]));
+}
+
+__attribute__((target("avx512f")))
+inline double horizontal_product(__m512d x) noexcept
+{
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, x);
+    return ((lanes[0]*lanes[4])*(lanes[2]*lanes[6]))
+        *((lanes[1]*lanes[5])*(lanes[3]*lanes[7]));
+}
+
+__attribute__((target("avx512f")))
+inline double abs_sum(const double* a, std::size_t n) noexcept
+{
+    __m512d acc = _mm512_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm512_add_pd(acc, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+    double res = horizontal_sum(acc);
+    for (; i < n; ++i)
+        res += std::fabs(a[i]);
+    return res;
+}
+
+__attribute__((target("avx512f")))
+inline double product(const double* a, std::size_t n) noexcept
+{
+    __m512d acc = _mm512_set1_pd(1.0);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        acc = _mm512_mul_pd(acc, _mm512_loadu_pd(a + i));
+    double res = horizontal_product(acc);
+    for (; i < n; ++i)
+        res *= a[i];
+    return res;
+}
+
+}
+#endif
+
+// Widest instruction set supported by both the build and the CPU.
+[[nodiscard]] inline InstructionSet detect_instruction_set() noexcept
+{
+#ifdef CUBAGE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return InstructionSet::AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return InstructionSet::AVX2;
+#endif
+    return InstructionSet::SCALAR;
+}
+
+/*
+    Kernels for the given instruction set, which must be supported by the CPU.
+    Falls back to the scalar kernels if the instruction set is not available
+    in the build.
+*/
+[[nodiscard]] inline KernelTable
+make_kernel_table(InstructionSet instruction_set) noexcept
+{
+#ifdef CUBAGE_SIMD_X86
+    if (instruction_set == InstructionSet::AVX512)
+        return {
+            InstructionSet::AVX512, avx512::add, avx512::subtract, 
+            avx512::multiply, avx512::scale, avx512::abs_sum, avx512::product
+        };
+    if (instruction_set == InstructionSet::AVX2)
+        return {
+            InstructionSet::AVX2, avx2::add, avx2::subtract, avx2::multiply,
+            avx2::scale, avx2::abs_sum, avx2::product
+        };
+#else
+    (void)instruction_set;
+#endif
+    return {
+        InstructionSet::SCALAR, scalar::add, scalar::subtract, 
+        scalar::multiply, scalar::scale, scalar::abs_sum, scalar::product
+    };
+}
+
+// Kernels selected for the CPU on first use.
+[[nodiscard]] inline const KernelTable& kernels() noexcept
+{
+    static const KernelTable table = make_kernel_table(detect_instruction_set());
+    return table;
+}
+
+}
\ No newline at end of file
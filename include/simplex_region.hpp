@@ -22,26 +22,75 @@ SOFTWARE.
 #pragma once
 
 #include <array>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
 
 #include "concepts.hpp"
+#include "integral_result.hpp"
 
-template <typename T>
+namespace cubage
+{
+
+/*
+    Simplex in `n` dimensions given by its `n + 1` vertices.
+*/
+template <typename FieldType>
+    requires ArrayLike<FieldType> && FloatingPointVectorOperable<FieldType>
 struct Simplex
 {
-    std::array<T, std::tuple_size<T>::value + 1> vertices;
+    using value_type = typename FieldType::value_type;
+    static constexpr std::size_t ndim = std::tuple_size<FieldType>::value;
+
+    std::array<FieldType, ndim + 1> vertices;
 
-    [[nodiscard]] std::pair<Simplex, Simplex> subdivide_longest_edge()
+    [[nodiscard]] constexpr value_type volume() const noexcept
+    {
+        // |det(v_1 - v_0, ..., v_n - v_0)|/n! by Gaussian elimination with
+        // partial pivoting
+        std::array<FieldType, ndim> edges;
+        for (std::size_t i = 0; i < ndim; ++i)
+            edges[i] = vertices[i + 1] - vertices[0];
+
+        value_type det = 1.0;
+        for (std::size_t i = 0; i < ndim; ++i)
+        {
+            std::size_t pivot = i;
+            for (std::size_t j = i + 1; j < ndim; ++j)
+                if (std::fabs(edges[j][i]) > std::fabs(edges[pivot][i]))
+                    pivot = j;
+            if (edges[pivot][i] == 0.0) return 0.0;
+            std::swap(edges[i], edges[pivot]);
+
+            det *= edges[i][i];
+            for (std::size_t j = i + 1; j < ndim; ++j)
+            {
+                const value_type factor = edges[j][i]/edges[i][i];
+                for (std::size_t k = i; k < ndim; ++k)
+                    edges[j][k] -= factor*edges[i][k];
+            }
+        }
+
+        value_type factorial = 1.0;
+        for (std::size_t i = 2; i <= ndim; ++i)
+            factorial *= value_type(i);
+        return std::fabs(det)/factorial;
+    }
+
+    [[nodiscard]] constexpr std::pair<Simplex, Simplex>
+    subdivide_longest_edge() const noexcept
     {
         std::pair<std::size_t, std::size_t> inds{};
-        double max_length_sqr = 0.0;
-        for (std::size_t i = 0; i < std::tuple_size<T>::value; ++i)
+        value_type max_length_sqr = 0.0;
+        for (std::size_t i = 0; i < ndim + 1; ++i)
         {
-            for (std::size_t j = i + 1; j < std::tuple_size<T>::value; ++j)
+            for (std::size_t j = i + 1; j < ndim + 1; ++j)
             {
-                const T disp = vertices[j] - vertices[i];
-                const T disp2 = disp*disp;
-                const double length_sqr = std::accumulate(
-                        disp2.begin(), disp2.end(), 0.0);
+                const FieldType disp = vertices[j] - vertices[i];
+                const FieldType disp2 = disp*disp;
+                const value_type length_sqr = std::accumulate(
+                        disp2.begin(), disp2.end(), value_type{});
                 if (length_sqr > max_length_sqr)
                 {
                     max_length_sqr = length_sqr;
@@ -50,62 +99,73 @@ struct Simplex
             }
         }
 
-        const T center = 0.5*(vertices[inds.first] + vertices[inds.second]);
+        const FieldType center
+                = 0.5*(vertices[inds.first] + vertices[inds.second]);
 
         std::pair<Simplex, Simplex> res = {*this, *this};
-        res.first[inds.first] = center;
-        res.second[inds.second] = center;
+        res.first.vertices[inds.first] = center;
+        res.second.vertices[inds.second] = center;
 
         return res;
     }
 };
 
-template <typename Rule>
-class IntegrationSimplex
+template <typename FieldType>
+concept SimplexIntegratorSignature
+= requires (typename FieldType::CodomainType (*f)(typename FieldType::DomainType), typename FieldType::Limits limits)
+{
+    { FieldType::integrate(f, limits) } -> std::same_as<IntegralResult<typename FieldType::CodomainType>>;
+};
+
+/*
+    Simplex, which is subdivided into two halves by bisecting its longest 
+    edge. Repeated bisection of the longest edge keeps the simplices from 
+    degenerating.
+*/
+template <typename Domain>
+    requires ArrayLike<Domain>
+class SubdivisibleSimplex
 {
 public:
-    using DomainType = typename Rule::DomainType;
-    using CodomainType = typename Rule::CodomainType;
+    using DomainType = Domain;
     using Limits = Simplex<DomainType>;
-    using Result = IntegralResult<CodomainType>;
 
-    IntegrationSimplex() = default;
+    constexpr SubdivisibleSimplex() = default;
 
-    IntegrationSimplex(const Limits& p_limits)
-    : limits(p_limits), result_(), maxerr_() {}
+    explicit constexpr SubdivisibleSimplex(const Limits& p_limits):
+        m_limits(p_limits)
+    {
+        if (!(m_limits.volume() > 0))
+            throw std::invalid_argument(
+                    "invalid integration limits: degenerate simplex");
+    }
+
+    [[nodiscard]] constexpr const Limits&
+    limits() const noexcept { return m_limits; }
 
-    template <typename FuncType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
-    [[nodiscard]] constexpr std::pair<IntegrationSimplex, IntegrationSimplex>
-    subdivide(FuncType f) const
+    [[nodiscard]] constexpr std::pair<SubdivisibleSimplex, SubdivisibleSimplex>
+    subdivide() const noexcept
     {
-        const std::pair<Simplex, Simplex> verts
-            = limits.subdivide_longest_edge();
+        const auto& [first, second] = m_limits.subdivide_longest_edge();
 
-        std::pair<IntegrationSimplex, IntegrationSimplex> simplices = {
-            IntegrationSimplex(verts.first),
-            IntegrationSimplex(verts.second)
-        };
-        simplices.first.integrate(f);
-        simplices.second.integrate(f);
+        std::pair<SubdivisibleSimplex, SubdivisibleSimplex> simplices;
+        simplices.first.m_limits = first;
+        simplices.second.m_limits = second;
 
         return simplices;
     }
 
-    template <typename FuncType>
-        requires MapsAs<FuncType, DomainType, CodomainType>
-    const IntegralResult<CodomainType>& integrate(FuncType f)
+    template <typename Rule, typename FuncType>
+        requires MapsAs<FuncType, DomainType, typename Rule::CodomainType>
+            && SimplexIntegratorSignature<Rule>
+    [[nodiscard]] constexpr const IntegralResult<typename Rule::CodomainType> 
+    integrate(FuncType f)
     {
-        result_ = Rule::integrate(f, limits);
-        if constexpr (std::is_floating_point<CodomainType>::value)
-            maxerr_ = res.err;
-        else
-            maxerr_ = *std::ranges::max_element(res.err);
-        return result_;
+        return Rule::integrate(f, m_limits);
     }
 
 private:
-    Limits limits;
-    IntegralResult<CodomainType> result_;
-    double maxerr_;
-};
\ No newline at end of file
+    Limits m_limits{};
+};
+
+}
\ No newline at end of file
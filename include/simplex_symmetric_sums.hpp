@@ -22,119 +22,72 @@ SOFTWARE.
 #pragma once
 
 #include <array>
+#include <algorithm>
 
 namespace cubage
 {
 
-template <std::size_t Dimension, typename S, typename T, typename FuncType>
-[[nodiscard]] static constexpr T symmetric_sum_axxxx(
-    double base_val, double extra_val, FuncType f, const std::array<S, Dimension + 1>& vertices)
-{
-    std::array<double, Dimension + 1> std_point{};
-    std_point.fill(base_val);
-
-    T sum{};
-    for (std::size_t i = 0; i < Dimension + 1; ++i)
-    {
-        std_point[i] = extra_val;
-        sum += f(affine_transform_point(std_point, vertices));
-        std_point[i] = base_val;
-    }
-
-    return sum;
-}
+/*
+    Flat table of `Count` points in barycentric coordinates of an n-simplex.
+    The coordinate of the first vertex follows from the others summing to
+    one, so each point stores only the remaining `n` coordinates.
+*/
+template <std::size_t Dimension, std::size_t Count>
+using BarycentricTable = std::array<std::array<double, Dimension>, Count>;
 
-template <std::size_t Dimension, typename S, typename T, typename FuncType>
-[[nodiscard]] static constexpr T symmetric_sum_aaxxx(
-    double base_val, double extra_val, FuncType f, const std::array<S, Dimension + 1>& vertices)
+/*
+    Write the orbit of the point with barycentric coordinates `coords` under
+    permutations of the vertices to `table`, starting at `offset`. Returns the
+    offset one past the orbit.
+*/
+template <std::size_t Dimension, std::size_t Count>
+constexpr std::size_t append_symmetric_orbit(
+    std::array<double, Dimension + 1> coords,
+    BarycentricTable<Dimension, Count>& table, std::size_t offset) noexcept
 {
-    std::array<double, Dimension + 1> std_point{};
-    std_point.fill(base_val);
-
-    T sum{};
-    for (std::size_t i = 0; i < Dimension + 1; ++i)
+    std::ranges::sort(coords);
+    do
     {
-        std_point[i] = extra_val;
-        for (std::size_t j = i + 1; j < Dimension + 1; ++j)
-        {
-            std_point[j] = extra_val;
-            sum += f(affine_transform_point(std_point, vertices));
-            std_point[j] = base_val;
-        }
-        std_point[i] = base_val;
+        std::ranges::copy(coords.begin() + 1, coords.end(), table[offset].begin());
+        ++offset;
     }
-
-    return sum;
+    while (std::ranges::next_permutation(coords).found);
+    return offset;
 }
 
-template <std::size_t Dimension, typename S, typename T, typename FuncType>
-[[nodiscard]] static constexpr T symmetric_sum_abxxx(
-    double base_val, const std::array<double, 2>& extra_vals, FuncType f, const std::array<S, Dimension + 1>& vertices)
+/*
+    Affine map from barycentric coordinates to the simplex with the given
+    vertices. The edges from the first vertex are the columns of its matrix, 
+    which is set up once per simplex, so mapping a point of a 
+    `BarycentricTable` is a single small matrix-vector product.
+*/
+template <typename S, std::size_t Dimension>
+class SimplexAffineMap
 {
+public:
+    using value_type = typename S::value_type;
 
-    std::array<double, Dimension + 1> std_point{};
-    std_point.fill(base_val);
-
-    T sum{};
-    for (std::size_t i = 0; i < Dimension + 1; ++i)
+    explicit constexpr SimplexAffineMap(
+        const std::array<S, Dimension + 1>& vertices) noexcept:
+        m_origin(vertices[0])
     {
-        std_point[i] = extra_vals[0];
-        for (std::size_t j = 0; j < i; ++j)
-        {
-            std_point[j] = extra_vals[1];
-            sum += f(affine_transform_point(std_point, vertices));
-            std_point[j] = base_val;
-        }
-        for (std::size_t j = i + 1; j < Dimension + 1; ++j)
-        {
-            std_point[j] = extra_vals[1];
-            sum += f(affine_transform_point(std_point, vertices));
-            std_point[j] = base_val;
-        }
-        std_point[i] = base_val;
+        for (std::size_t k = 0; k < Dimension; ++k)
+            m_edges[k] = vertices[k + 1] - vertices[0];
     }
-}
-
-template <std::size_t Dimension, typename S, typename T, typename FuncType>
-[[nodiscard]] static constexpr T symmetric_sum_aaaxx(
-    double base_val, double extra_val, FuncType f, const std::array<S, Dimension + 1>& vertices)
-{
-    std::array<double, Dimension + 1> std_point{};
-    std_point.fill(base_val);
 
-    T sum{};
-    for (std::size_t i = 0; i < Dimension + 1; ++i)
+    [[nodiscard]] constexpr S
+    operator()(const std::array<double, Dimension>& coords) const noexcept
     {
-        std_point[i] = extra_val;
-        for (std::size_t j = i + 1; j < Dimension + 1; ++j)
-        {
-            std_point[j] = extra_val;
-            for (std::size_t k = j + 1; k < Dimension + 1; ++k)
-            {
-                std_point[k] = extra_val;
-                sum += f(affine_transform_point(std_point, vertices));
-                std_point[k] = base_val;
-            }
-            std_point[j] = base_val;
-        }
-        std_point[i] = base_val;
+        S point = m_origin;
+        for (std::size_t k = 0; k < Dimension; ++k)
+            for (std::size_t i = 0; i < point.size(); ++i)
+                point[i] += value_type(coords[k])*m_edges[k][i];
+        return point;
     }
 
-    return sum;
-}
-
-
-
-template <std::size_t Dimension, typename S>
-[[nodiscard]] static constexpr inline S
-affine_transform_point(
-    const std::array<double, Dimension + 1>& std_point,
-    const std::array<S, Dimension + 1>& vertices)
-{
-    S point{};
-    for (std::size_t k = 0; k < Dimension + 1; ++k)
-        point += std_point[k]*vertices[k];
-    return point;
-}
+private:
+    S m_origin;
+    std::array<S, Dimension> m_edges;
+};
 
 }
\ No newline at end of file
@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <concepts>
+#include <exception>
+#include <stdexcept>
+
+namespace cubage
+{
+
+/*
+    Fixed-size pool of worker threads for data-parallel loops.
+
+    The only operation is `for_each_index`, which calls `task(i)` for each
+    `i < count`, and blocks until all calls have returned. Alternatively, the
+    task may take the index of the executing thread as a second argument
+    `task(i, thread_index)`, where `thread_index < size()`, which allows tasks
+    to use per-thread workspaces. The calling thread participates in the work
+    with thread index 0, so a pool of size `n` spawns `n - 1` workers. If a
+    task throws, no further tasks are started, and the first exception is 
+    rethrown by `for_each_index` once the running tasks have returned.
+
+    Calls of `for_each_index` from different threads are serialized, so a 
+    pool may be shared, e.g., by copies of an integrator. Calls from within
+    a task of the same pool are not supported, since they would wait for the
+    call they are part of, and throw `std::logic_error`.
+*/
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t num_threads)
+    {
+        const std::size_t num_workers = (num_threads > 1) ? num_threads - 1 : 0;
+        m_workers.reserve(num_workers);
+        for (std::size_t i = 0; i < num_workers; ++i)
+            m_workers.emplace_back([this, i](){ work(i + 1); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::scoped_lock lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_workers.size() + 1;
+    }
+
+    template <typename TaskType>
+        requires std::invocable<TaskType&, std::size_t>
+            || std::invocable<TaskType&, std::size_t, std::size_t>
+    void for_each_index(std::size_t count, TaskType&& task)
+    {
+        if (s_running_pool == this)
+            throw std::logic_error(
+                    "ThreadPool::for_each_index called from within a task of "
+                    "the same pool");
+
+        if (count == 0) return;
+        if (m_workers.empty() || count == 1)
+        {
+            const RunningGuard guard(this);
+            for (std::size_t i = 0; i < count; ++i)
+                call(task, i, 0);
+            return;
+        }
+
+        std::scoped_lock call_lock(m_call_mutex);
+        {
+            std::scoped_lock lock(m_mutex);
+            m_task = [&task](std::size_t i, std::size_t thread_index)
+            {
+                call(task, i, thread_index);
+            };
+            m_count = count;
+            m_next_index = 0;
+            m_exception = nullptr;
+            m_active_workers = m_workers.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+
+        run_tasks(0);
+
+        std::exception_ptr exception;
+        {
+            std::unique_lock lock(m_mutex);
+            m_done.wait(lock, [this](){ return m_active_workers == 0; });
+            m_task = nullptr;
+            std::swap(exception, m_exception);
+        }
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+private:
+    // Marks the pool whose tasks the current thread is running.
+    class RunningGuard
+    {
+    public:
+        explicit RunningGuard(const ThreadPool* pool) noexcept:
+            m_previous(s_running_pool)
+        {
+            s_running_pool = pool;
+        }
+
+        RunningGuard(const RunningGuard&) = delete;
+        RunningGuard& operator=(const RunningGuard&) = delete;
+
+        ~RunningGuard() { s_running_pool = m_previous; }
+
+    private:
+        const ThreadPool* m_previous;
+    };
+
+    template <typename TaskType>
+    static void call(TaskType& task, std::size_t i, std::size_t thread_index)
+    {
+        if constexpr (std::invocable<TaskType&, std::size_t, std::size_t>)
+            task(i, thread_index);
+        else
+            task(i);
+    }
+
+    void run_tasks(std::size_t thread_index)
+    {
+        const RunningGuard guard(this);
+        for (std::size_t i = m_next_index++; i < m_count; i = m_next_index++)
+        {
+            try
+            {
+                m_task(i, thread_index);
+            }
+            catch (...)
+            {
+                std::scoped_lock lock(m_mutex);
+                if (!m_exception)
+                    m_exception = std::current_exception();
+                m_next_index = m_count;
+            }
+        }
+    }
+
+    void work(std::size_t thread_index)
+    {
+        std::size_t generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(m_mutex);
+                m_start.wait(lock, [&](){
+                    return m_stop || m_generation != generation;
+                });
+                if (m_stop) return;
+                generation = m_generation;
+            }
+
+            run_tasks(thread_index);
+
+            {
+                std::scoped_lock lock(m_mutex);
+                --m_active_workers;
+            }
+            m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_call_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_start;
+    std::condition_variable m_done;
+    std::function<void(std::size_t, std::size_t)> m_task;
+    std::exception_ptr m_exception;
+    std::atomic<std::size_t> m_next_index{};
+    std::size_t m_count{};
+    std::size_t m_active_workers{};
+    std::size_t m_generation{};
+    bool m_stop = false;
+
+    static inline thread_local const ThreadPool* s_running_pool = nullptr;
+};
+
+}
\ No newline at end of file
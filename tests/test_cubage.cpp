@@ -20,6 +20,15 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <memory_resource>
 #include <cassert>
 
 #include "array_arithmetic.hpp"
@@ -49,6 +58,29 @@ bool gauss_kronrod_integrates_1d_gaussian()
     return close(result.val, sigma*std::sqrt(2.0*M_PI), abserr);
 }
 
+bool romberg_integrates_1d_gaussian_with_counted_evaluations()
+{
+    using Integrator = cubage::RombergIntegrator<double, double>;
+    constexpr double sigma = 0.01;
+    std::size_t count = 0;
+    auto function = [sigma, &count](double x)
+    {
+        ++count;
+        const double z = x/sigma;
+        return std::exp(-0.5*z*z);
+    };
+
+    constexpr double abserr = 1.0e-12;
+    constexpr double relerr = 0.0;
+    Integrator::Limits limits = Integrator::Limits{-1.0, 1.0};
+    Integrator integrator{};
+    const auto& [result, _] = integrator.integrate(function, limits, abserr, relerr);
+    std::cout << result.val << '\n';
+    std::cout << result.err << '\n';
+    return close(result.val, sigma*std::sqrt(2.0*M_PI), abserr)
+        && count == integrator.func_eval_count();
+}
+
 bool genz_malik_integrates_2d_gaussian()
 {
     using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
@@ -91,10 +123,989 @@ bool genz_malik_integrates_3d_gaussian()
     return close(result.val, sigma*sigma*sigma*std::pow(2.0*M_PI, 1.5), abserr);
 }
 
+bool genz_malik_converges_to_relative_tolerance_for_negative_integral()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    auto function = [](const std::array<double, 2>& x)
+    {
+        return std::cos(3.0*(x[0] + x[1]));
+    };
+
+    constexpr double abserr = 0.0;
+    constexpr double relerr = 1.0e-6;
+    constexpr std::size_t max_subdiv = 10000;
+    Integrator::Limits limits = Integrator::Limits{{0.0, 0.0}, {1.0, 1.0}};
+    Integrator integrator;
+    const auto& [result, status] = integrator.integrate(
+            function, limits, abserr, relerr, max_subdiv);
+    const double expected = (2.0/9.0)*(std::cos(3.0) - 1.0)
+        - (1.0/9.0)*(std::cos(6.0) - 1.0);
+    std::cout << result.val << '\n';
+    std::cout << result.err << '\n';
+    return result.val < 0.0 && status == cubage::Status::SUCCESS
+        && integrator.region_count() < max_subdiv
+        && close(result.val, expected, 10.0*relerr*std::fabs(expected));
+}
+
+bool nested_genz_malik_integrates_3d_gaussian_with_counted_evaluations()
+{
+    using Integrator = cubage::NestedHypercubeIntegrator<std::array<double, 3>, double>;
+    constexpr double sigma = 0.01;
+    std::size_t count = 0;
+    auto function = [sigma, &count](const std::array<double, 3>& x)
+    {
+        ++count;
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+    };
+
+    constexpr double abserr = 1.0e-12;
+    constexpr double relerr = 0.0;
+    Integrator::Limits limits = Integrator::Limits{
+        {-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}
+    };
+    Integrator integrator{};
+    const auto& [result, _] = integrator.integrate(function, limits, abserr, relerr);
+    std::cout << result.val << '\n';
+    std::cout << result.err << '\n';
+    return close(result.val, sigma*sigma*sigma*std::pow(2.0*M_PI, 1.5), abserr)
+        && count == integrator.func_eval_count();
+}
+
+bool genz_malik_integrates_3d_gaussian_with_batched_integrand()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 3>, double>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](
+        std::span<const std::array<double, 3>> x, std::span<double> y)
+    {
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            const auto z = (1.0/sigma)*x[i];
+            const auto z2 = z*z;
+            y[i] = std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+        }
+    };
+
+    constexpr double abserr = 1.0e-13;
+    constexpr double relerr = 0.0;
+    Integrator::Limits limits = Integrator::Limits{
+        {-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}
+    };
+    const auto& [result, _] = Integrator().integrate(function, limits, abserr, relerr);
+    std::cout << result.val << '\n';
+    std::cout << result.err << '\n';
+    return close(result.val, sigma*sigma*sigma*std::pow(2.0*M_PI, 1.5), abserr);
+}
+
+bool parallel_genz_malik_is_independent_of_thread_count()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 3>, double>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](const std::array<double, 3>& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+    };
+
+    constexpr double abserr = 1.0e-13;
+    constexpr double relerr = 0.0;
+    Integrator::Limits limits = Integrator::Limits{
+        {-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}
+    };
+    const auto& [result_2, status_2]
+        = Integrator(2).integrate(function, limits, abserr, relerr);
+    const auto& [result_4, status_4]
+        = Integrator(4).integrate(function, limits, abserr, relerr);
+    std::cout << result_4.val << '\n';
+    std::cout << result_4.err << '\n';
+    return close(result_4.val, sigma*sigma*sigma*std::pow(2.0*M_PI, 1.5), abserr)
+        && result_2.val == result_4.val && result_2.err == result_4.err
+        && status_2 == status_4;
+}
+
+bool parallel_genz_malik_evaluates_regions_in_parallel_in_16d()
+{
+    constexpr std::size_t ndim = 16;
+    using Domain = std::array<double, ndim>;
+    using Integrator = cubage::HypercubeIntegrator<Domain, double>;
+    const std::thread::id main_thread = std::this_thread::get_id();
+    std::atomic<bool> called_from_worker = false;
+    auto function = [&](const Domain& x)
+    {
+        if (std::this_thread::get_id() != main_thread)
+            called_from_worker = true;
+        double sum = 0.0;
+        for (std::size_t i = 0; i < ndim; ++i)
+            sum += x[i]*x[i];
+        return std::exp(-sum);
+    };
+
+    constexpr double abserr = 0.0;
+    constexpr double relerr = 1.0e-3;
+    constexpr std::size_t max_subdiv = 8;
+    Integrator::Limits limits{};
+    limits.xmax.fill(1.0);
+    const auto& [serial_result, serial_status] = Integrator().integrate(
+            function, limits, abserr, relerr, max_subdiv);
+    const bool serial_on_main_thread = !called_from_worker;
+    const auto& [result_2, status_2] = Integrator(2).integrate(
+            function, limits, abserr, relerr, max_subdiv);
+    const bool parallel_on_workers = called_from_worker;
+    const auto& [result_4, status_4] = Integrator(4).integrate(
+            function, limits, abserr, relerr, max_subdiv);
+
+    return serial_on_main_thread && parallel_on_workers
+        && result_2.val == result_4.val && result_2.err == result_4.err
+        && status_2 == status_4 && serial_status == status_2
+        && close(result_2.val, serial_result.val, 1.0e-12*serial_result.val);
+}
+
+bool copied_integrator_refines_like_original()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](const std::array<double, 2>& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    Integrator::Limits limits = Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+    Integrator original(2);
+    [[maybe_unused]] const auto coarse
+        = original.integrate(function, limits, 1.0e-6, 0.0);
+
+    Integrator copy = original;
+    const auto& [result, status] = original.refine(function, 1.0e-12, 0.0);
+    const auto& [copy_result, copy_status] = copy.refine(function, 1.0e-12, 0.0);
+    return result.val == copy_result.val && result.err == copy_result.err
+        && status == copy_status
+        && original.region_count() == copy.region_count()
+        && original.func_eval_count() == copy.func_eval_count();
+}
+
+bool stored_region_results_sum_to_integral()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    auto function = [](const std::array<double, 2>& x)
+    {
+        return std::exp(-(x[0]*x[0] + x[1]*x[1]));
+    };
+
+    Integrator::Limits limits = Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+    Integrator integrator{};
+    const auto& [result, _] = integrator.integrate(function, limits, 1.0e-10, 0.0);
+
+    double val = 0.0;
+    for (const auto& region_result : integrator.results())
+        val += region_result.val;
+
+    double volume = 0.0;
+    for (const auto& region : integrator.regions())
+        volume += region.limits().volume();
+
+    return integrator.regions().size() == integrator.region_count()
+        && close(val, result.val, 1.0e-14) && close(volume, 4.0, 1.0e-14);
+}
+
+bool refined_integral_matches_direct_integral()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](const std::array<double, 2>& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    Integrator::Limits limits = Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+
+    Integrator direct{};
+    const auto& [direct_result, direct_status]
+        = direct.integrate(function, limits, 1.0e-12, 0.0);
+
+    Integrator refined{};
+    [[maybe_unused]] const auto coarse
+        = refined.integrate(function, limits, 1.0e-6, 0.0);
+    const std::size_t coarse_count = refined.region_count();
+    [[maybe_unused]] const auto medium = refined.refine(function, 1.0e-9, 0.0);
+    const auto& [refined_result, refined_status]
+        = refined.refine(function, 1.0e-12, 0.0);
+
+    return coarse_count < refined.region_count()
+        && direct_status == refined_status
+        && close(direct_result.val, refined_result.val, 1.0e-12)
+        && refined_result.err <= 1.0e-12
+        && refined.func_eval_count() <= direct.func_eval_count() + 2*Integrator::RegionType::RuleType::points_count();
+}
+
+bool restored_checkpoint_continues_integration()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    constexpr double sigma = 0.01;
+    std::size_t count = 0;
+    auto function = [sigma, &count](const std::array<double, 2>& x)
+    {
+        ++count;
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    Integrator::Limits limits = Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+
+    Integrator original{};
+    [[maybe_unused]] const auto coarse
+        = original.integrate(function, limits, 1.0e-6, 0.0);
+
+    std::stringstream checkpoint;
+    original.save(checkpoint);
+
+    Integrator restored{};
+    const std::size_t count_before_load = count;
+    restored.load(checkpoint);
+    const bool no_evaluations = count == count_before_load;
+
+    const auto& [original_result, original_status]
+        = original.refine(function, 1.0e-12, 0.0);
+    const auto& [restored_result, restored_status]
+        = restored.refine(function, 1.0e-12, 0.0);
+
+    bool rejects_garbage = false;
+    try
+    {
+        std::stringstream garbage("not a checkpoint");
+        Integrator().load(garbage);
+    }
+    catch (const std::runtime_error&)
+    {
+        rejects_garbage = true;
+    }
+
+    bool rejects_other_rule = false;
+    try
+    {
+        std::stringstream other_rule;
+        original.save(other_rule);
+        cubage::HypercubeIntegratorOfDegree<std::array<double, 2>, double, 9>()
+            .load(other_rule);
+    }
+    catch (const std::runtime_error&)
+    {
+        rejects_other_rule = true;
+    }
+
+    return no_evaluations && rejects_garbage && rejects_other_rule
+        && original_status == restored_status
+        && original_result.val == restored_result.val
+        && original_result.err == restored_result.err
+        && original.region_count() == restored.region_count()
+        && original.func_eval_count() == restored.func_eval_count();
+}
+
+bool failed_checkpoint_load_keeps_state()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](const std::array<double, 2>& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    Integrator::Limits limits = Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+
+    Integrator other{};
+    [[maybe_unused]] const auto other_result
+        = other.integrate(function, limits, 1.0e-10, 0.0);
+    std::stringstream full;
+    other.save(full);
+    const std::string data = full.str();
+
+    Integrator original{};
+    [[maybe_unused]] const auto coarse
+        = original.integrate(function, limits, 1.0e-6, 0.0);
+    Integrator untouched = original;
+
+    // Cut the checkpoint after the regions, and at its very end.
+    bool rejects_truncated = true;
+    for (const std::size_t cut : {data.size()/2, data.size() - 1})
+    {
+        try
+        {
+            std::stringstream truncated(data.substr(0, cut));
+            original.load(truncated);
+            rejects_truncated = false;
+        }
+        catch (const std::runtime_error&) {}
+    }
+
+    const auto& [original_result, original_status]
+        = original.refine(function, 1.0e-12, 0.0);
+    const auto& [untouched_result, untouched_status]
+        = untouched.refine(function, 1.0e-12, 0.0);
+
+    return rejects_truncated
+        && original_status == untouched_status
+        && original_result.val == untouched_result.val
+        && original_result.err == untouched_result.err
+        && original.region_count() == untouched.region_count()
+        && original.func_eval_count() == untouched.func_eval_count();
+}
+
+template <cubage::RegionQueue QueueType>
+bool genz_malik_integrates_2d_gaussian_with_queue()
+{
+    using Integrator = cubage::HypercubeIntegrator<
+        std::array<double, 2>, double, QueueType>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](const std::array<double, 2>& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    constexpr double abserr = 1.0e-13;
+    constexpr double relerr = 0.0;
+    using Limits = typename Integrator::Limits;
+    const Limits limits = Limits{{-1.0, -1.0}, {1.0, 1.0}};
+    const auto& [result, _] = Integrator().integrate(function, limits, abserr, relerr);
+    return close(result.val, sigma*sigma*2.0*M_PI, abserr);
+}
+
+bool batch_integrates_parametrized_gaussians_independently()
+{
+    using Integrator = cubage::HypercubeIntegrator<std::array<double, 2>, double>;
+    using BatchIntegrator
+        = cubage::BatchHypercubeIntegrator<std::array<double, 2>, double>;
+    auto function = [](const std::array<double, 2>& x, double sigma)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    constexpr double abserr = 1.0e-10;
+    constexpr double relerr = 0.0;
+    const Integrator::Limits limits = Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+    const std::vector<double> sigmas = {0.01, 0.02, 0.05, 0.1};
+
+    BatchIntegrator batch(3);
+    const auto results
+        = batch.integrate_parametric(function, sigmas, limits, abserr, relerr);
+
+    std::size_t func_eval_count = 0;
+    for (std::size_t i = 0; i < sigmas.size(); ++i)
+    {
+        const double sigma = sigmas[i];
+        Integrator integrator;
+        const auto& [result, status] = integrator.integrate(
+            [&](const std::array<double, 2>& x){ return function(x, sigma); },
+            limits, abserr, relerr);
+        func_eval_count += integrator.func_eval_count();
+        if (results[i].value.val != result.val
+            || results[i].value.err != result.err
+            || results[i].status != status
+            || !close(result.val, sigma*sigma*2.0*M_PI, abserr))
+            return false;
+    }
+
+    std::vector<std::function<double(const std::array<double, 2>&)>> functions;
+    for (const double sigma : sigmas)
+        functions.push_back(
+            [&, sigma](const std::array<double, 2>& x){ return function(x, sigma); });
+    const auto serial_results
+        = BatchIntegrator().integrate(functions, limits, abserr, relerr, 16);
+    for (const auto& [result, status] : serial_results)
+    {
+        if (status != cubage::Status::MAX_SUBDIV)
+            return false;
+    }
+
+    return batch.func_eval_count() == func_eval_count;
+}
+
+bool batch_rethrows_failure_of_one_integrand()
+{
+    using BatchIntegrator
+        = cubage::BatchHypercubeIntegrator<std::array<double, 2>, double>;
+    auto function = [](const std::array<double, 2>& x, double sigma)
+    {
+        if (sigma < 0.0)
+            throw std::domain_error("negative width");
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1]));
+    };
+
+    constexpr double abserr = 1.0e-10;
+    constexpr double relerr = 0.0;
+    const BatchIntegrator::Limits limits{{-1.0, -1.0}, {1.0, 1.0}};
+    const std::vector<double> sigmas = {0.01, 0.02, -0.05, 0.1, 0.2, 0.3};
+    const std::vector<double> valid_sigmas = {0.01, 0.02, 0.1};
+
+    bool all_rethrown = true;
+    for (const std::size_t num_threads : {1, 2, 4})
+    {
+        BatchIntegrator batch(num_threads);
+        bool rethrown = false;
+        try
+        {
+            [[maybe_unused]] const auto results = batch.integrate_parametric(
+                    function, sigmas, limits, abserr, relerr);
+        }
+        catch (const std::domain_error&)
+        {
+            rethrown = true;
+        }
+
+        // the batch integrator remains usable after the failure
+        const auto results = batch.integrate_parametric(
+                function, valid_sigmas, limits, abserr, relerr);
+        all_rethrown = all_rethrown && rethrown
+            && results.size() == valid_sigmas.size()
+            && results[2].status == cubage::Status::SUCCESS;
+    }
+
+    // an integrand which calls its own batch integrator
+    BatchIntegrator batch(2);
+    bool rejects_nested = false;
+    try
+    {
+        [[maybe_unused]] const auto results = batch.integrate_parametric(
+            [&](const std::array<double, 2>& x, double sigma)
+            {
+                return batch.integrate_parametric(
+                        function, std::vector<double>{sigma}, limits,
+                        abserr, relerr)[0].value.val*function(x, sigma);
+            }, valid_sigmas, limits, abserr, relerr);
+    }
+    catch (const std::logic_error&)
+    {
+        rejects_nested = true;
+    }
+
+    return all_rethrown && rejects_nested;
+}
+
+bool componentwise_norm_retires_converged_components()
+{
+    using Domain = std::array<double, 2>;
+    using Codomain = std::array<double, 2>;
+    using Rule = cubage::GenzMalikD7<Domain, Codomain>;
+    using IndividualIntegrator = cubage::MultiIntegrator<Rule>;
+    using ComponentwiseIntegrator
+        = cubage::MultiIntegrator<Rule, cubage::NormComponentwise>;
+    constexpr double sigma = 0.05;
+    auto function = [sigma](const Domain& x)
+    {
+        const auto z2 = x*x;
+        const auto w2 = (1.0/(sigma*sigma))*z2;
+        return Codomain{
+            1.0e+6*std::exp(-(z2[0] + z2[1])), std::exp(-0.5*(w2[0] + w2[1]))
+        };
+    };
+
+    constexpr double abserr = 0.0;
+    constexpr double relerr = 1.0e-9;
+    const IndividualIntegrator::Limits limits
+        = IndividualIntegrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+
+    IndividualIntegrator individual;
+    const auto& [individual_result, individual_status]
+        = individual.integrate(function, limits, abserr, relerr);
+    ComponentwiseIntegrator componentwise;
+    const auto& [result, status]
+        = componentwise.integrate(function, limits, abserr, relerr);
+    std::cout << individual.region_count() << ' '
+        << componentwise.region_count() << '\n';
+    if (status != cubage::Status::SUCCESS
+        || individual_status != cubage::Status::SUCCESS
+        || componentwise.func_eval_count() >= individual.func_eval_count()
+        || !close(result.val[1], sigma*sigma*2.0*M_PI, relerr*result.val[1])
+        || !std::ranges::all_of(componentwise.component_status(),
+            [](cubage::Status s){ return s == cubage::Status::SUCCESS; }))
+        return false;
+
+    const auto& [limited_result, limited_status]
+        = componentwise.integrate(function, limits, abserr, relerr, 1024);
+    const auto component_status = componentwise.component_status();
+
+    // The statuses are restored from a checkpoint.
+    std::stringstream checkpoint;
+    componentwise.save(checkpoint);
+    ComponentwiseIntegrator restored;
+    restored.load(checkpoint);
+    const auto restored_status = restored.component_status();
+
+    return limited_status == cubage::Status::MAX_SUBDIV
+        && component_status[0] == cubage::Status::SUCCESS
+        && component_status[1] == cubage::Status::MAX_SUBDIV
+        && std::ranges::equal(restored_status, component_status);
+}
+
+template <std::size_t NDIM>
+bool dynamic_hypercube_matches_fixed_dimension()
+{
+    using Integrator
+        = cubage::HypercubeIntegrator<std::array<double, NDIM>, double>;
+    using DynamicIntegrator = cubage::DynamicHypercubeIntegrator<double>;
+    constexpr double sigma = 0.1;
+    auto function = [sigma](std::span<const double> x)
+    {
+        double r2 = 0.0;
+        for (const double element : x)
+            r2 += element*element;
+        return std::exp(-0.5*r2/(sigma*sigma));
+    };
+
+    constexpr double abserr = 1.0e-9;
+    constexpr double relerr = 0.0;
+    std::array<double, NDIM> xmin{};
+    std::array<double, NDIM> xmax{};
+    xmin.fill(-1.0);
+    xmax.fill(1.0);
+
+    Integrator integrator;
+    const auto& [result, status] = integrator.integrate(
+        [&](const std::array<double, NDIM>& x)
+        {
+            return function(std::span<const double>(x));
+        },
+        typename Integrator::Limits{xmin, xmax}, abserr, relerr, 2000);
+
+    const std::vector<double> dynamic_xmin(xmin.begin(), xmin.end());
+    const std::vector<double> dynamic_xmax(xmax.begin(), xmax.end());
+    const typename DynamicIntegrator::Limits dynamic_limits(
+            dynamic_xmin, dynamic_xmax);
+    DynamicIntegrator dynamic_integrator;
+    const auto& [dynamic_result, dynamic_status] = dynamic_integrator.integrate(
+        function, dynamic_limits, abserr, relerr, 2000);
+
+    DynamicIntegrator parallel_integrator(2);
+    const auto& [parallel_result, parallel_status]
+        = parallel_integrator.integrate(
+            function, dynamic_limits, abserr, relerr, 2000);
+
+    // The visited integrator stores limits for at most twice the dimension.
+    const auto [visited_result, visited_max_ndim]
+        = cubage::visit_dynamic_hypercube_integrator<double>(NDIM,
+            [&](auto& visited_integrator)
+            {
+                using VisitedIntegrator
+                    = std::remove_cvref_t<decltype(visited_integrator)>;
+                const auto& [res, visited_status] = visited_integrator.integrate(
+                        function,
+                        typename VisitedIntegrator::Limits(dynamic_xmin, dynamic_xmax),
+                        abserr, relerr, 2000);
+                return std::pair(
+                        res, sizeof(typename VisitedIntegrator::Limits)/(2*sizeof(double)));
+            });
+
+    return dynamic_result.val == result.val
+        && dynamic_result.err == result.err
+        && dynamic_status == status
+        && dynamic_integrator.region_count() == integrator.region_count()
+        && dynamic_integrator.func_eval_count() == integrator.func_eval_count()
+        && close(parallel_result.val, result.val, 10.0*result.err)
+        && visited_result.val == result.val
+        && visited_max_ndim >= NDIM && visited_max_ndim < 2*NDIM;
+}
+
+template <std::size_t Degree>
+bool integrates_2d_gaussian_with_degree(std::size_t& func_eval_count)
+{
+    using Integrator = cubage::HypercubeIntegratorOfDegree<
+            std::array<double, 2>, double, Degree>;
+    constexpr double sigma = 0.2;
+    auto function = [sigma](const std::array<double, 2>& x)
+    {
+        const double z0 = (x[0] - 0.1)/sigma;
+        const double z1 = (x[1] - 0.1)/sigma;
+        return std::exp(-0.5*(z0*z0 + z1*z1));
+    };
+
+    constexpr double abserr = 0.0;
+    constexpr double relerr = 1.0e-10;
+    const auto limits = typename Integrator::Limits{{-1.0, -1.0}, {1.0, 1.0}};
+    Integrator integrator;
+    const auto& [result, status] = integrator.integrate(
+            function, limits, abserr, relerr);
+    func_eval_count = integrator.func_eval_count();
+
+    const double sigma_erf = sigma*std::sqrt(2.0);
+    const double expected = 0.25*M_PI*sigma_erf*sigma_erf*std::pow(
+            std::erf(1.1/sigma_erf) + std::erf(0.9/sigma_erf), 2);
+    return status == cubage::Status::SUCCESS
+        && close(result.val, expected, relerr*expected);
+}
+
+bool higher_degree_rules_need_fewer_evaluations()
+{
+    std::size_t d7_count = 0;
+    std::size_t d9_count = 0;
+    std::size_t d11_count = 0;
+    const bool accurate = integrates_2d_gaussian_with_degree<7>(d7_count)
+        && integrates_2d_gaussian_with_degree<9>(d9_count)
+        && integrates_2d_gaussian_with_degree<11>(d11_count);
+    std::cout << d7_count << ' ' << d9_count << ' ' << d11_count << '\n';
+    return accurate && d9_count < d7_count && d11_count < d9_count;
+}
+
+bool null_rule_error_needs_fewer_regions_for_3d_gaussian()
+{
+    using Domain = std::array<double, 3>;
+    using Integrator = cubage::HypercubeIntegrator<Domain, double>;
+    using NullRuleIntegrator = cubage::MultiIntegrator<
+            cubage::GenzMalikD7<Domain, double, cubage::NullRuleError>>;
+    constexpr double sigma = 0.1;
+    auto function = [sigma](const Domain& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+    };
+
+    constexpr double abserr = 1.0e-10;
+    constexpr double relerr = 0.0;
+    const Integrator::Limits limits{{-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}};
+    Integrator integrator;
+    const auto& [result, status] = integrator.integrate(
+            function, limits, abserr, relerr);
+    NullRuleIntegrator null_rule_integrator;
+    const auto& [null_rule_result, null_rule_status]
+        = null_rule_integrator.integrate(function, limits, abserr, relerr);
+
+    std::cout << integrator.region_count() << ' '
+        << null_rule_integrator.region_count() << '\n';
+    const double expected = sigma*sigma*sigma*std::pow(2.0*M_PI, 1.5);
+    return close(result.val, expected, abserr)
+        && close(null_rule_result.val, expected, abserr)
+        && null_rule_integrator.region_count() < integrator.region_count();
+}
+
+bool simplex_integrator_integrates_3d_gaussian_over_triangulated_cube()
+{
+    using Domain = std::array<double, 3>;
+    using Integrator = cubage::SimplexIntegrator<Domain, double>;
+    constexpr double sigma = 0.2;
+    auto function = [sigma](const Domain& x)
+    {
+        const auto z = (1.0/sigma)*(x - Domain{0.5, 0.5, 0.5});
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+    };
+
+    // Kuhn triangulation of the unit cube into six simplices
+    std::vector<Integrator::Limits> simplices;
+    std::array<std::size_t, 3> axes = {0, 1, 2};
+    do
+    {
+        Integrator::Limits simplex{};
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            simplex.vertices[i + 1] = simplex.vertices[i];
+            simplex.vertices[i + 1][axes[i]] = 1.0;
+        }
+        simplices.push_back(simplex);
+    }
+    while (std::next_permutation(axes.begin(), axes.end()));
+
+    constexpr double abserr = 1.0e-10;
+    constexpr double relerr = 0.0;
+    Integrator integrator;
+    const auto& [result, status] = integrator.integrate(
+            function, simplices, abserr, relerr);
+    std::cout << result.val << ' ' << result.err << ' '
+        << integrator.region_count() << '\n';
+    const double factor = sigma*std::sqrt(2.0*M_PI)
+            *std::erf(0.5/(std::sqrt(2.0)*sigma));
+    return close(result.val, factor*factor*factor, abserr);
+}
+
+bool integrators_sharing_memory_pool_match_default_allocator()
+{
+    using Domain = std::array<double, 3>;
+    using Rule = cubage::GenzMalikD7<Domain, double>;
+    using Integrator = cubage::MultiIntegrator<Rule>;
+    using PoolIntegrator = cubage::pmr::MultiIntegrator<Rule>;
+    auto function = [](const Domain& x)
+    {
+        const auto z = 10.0*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+    };
+
+    constexpr double abserr = 1.0e-8;
+    constexpr double relerr = 0.0;
+    const Integrator::Limits limits{{-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}};
+    const auto& [result, status]
+        = Integrator().integrate(function, limits, abserr, relerr);
+
+    std::pmr::unsynchronized_pool_resource pool;
+    PoolIntegrator first(&pool);
+    PoolIntegrator second(&pool);
+    const auto& [first_result, first_status]
+        = first.integrate(function, limits, abserr, relerr);
+    const auto& [second_result, second_status]
+        = second.integrate(function, limits, 0.1*abserr, relerr);
+
+    return first_result.val == result.val && first_result.err == result.err
+        && close(second_result.val, result.val, abserr)
+        && second.region_count() > first.region_count();
+}
+
+bool memory_limit_retires_negligible_regions()
+{
+    using Domain = std::array<double, 3>;
+    using Integrator = cubage::HypercubeIntegrator<Domain, double>;
+    constexpr double sigma = 0.1;
+    auto function = [sigma](const Domain& x)
+    {
+        const auto z = (1.0/sigma)*x;
+        const auto z2 = z*z;
+        return std::exp(-0.5*(z2[0] + z2[1] + z2[2]));
+    };
+
+    constexpr double abserr = 1.0e-8;
+    constexpr double relerr = 0.0;
+    constexpr std::size_t max_regions = 5000;
+    const Integrator::Limits limits{{-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}};
+    Integrator integrator;
+    integrator.set_memory_limit(max_regions*Integrator::region_bytes);
+    const auto& [result, status] = integrator.integrate(
+            function, limits, abserr, relerr);
+
+    Integrator small_integrator;
+    small_integrator.set_memory_limit(100*Integrator::region_bytes);
+    const auto& [small_result, small_status] = small_integrator.integrate(
+            function, limits, abserr, relerr);
+
+    std::cout << integrator.region_count() << ' '
+        << integrator.retired_region_count() << '\n';
+    const double expected = sigma*sigma*sigma*std::pow(2.0*M_PI, 1.5);
+    return status == cubage::Status::SUCCESS
+        && close(result.val, expected, abserr)
+        && integrator.region_count() <= max_regions
+        && integrator.retired_region_count() > 0
+        && small_status == cubage::Status::MAX_MEMORY
+        && small_integrator.region_count() <= 100;
+}
+
+bool compensated_sum_keeps_small_updates()
+{
+    cubage::CompensatedResult<double> sum(cubage::IntegralResult<double>{1.0, 1.0});
+    cubage::IntegralResult<double> naive_sum{1.0, 1.0};
+    const cubage::IntegralResult<double> update{1.0e-16, 1.0e-16};
+    for (std::size_t i = 0; i < 1000000; ++i)
+    {
+        sum += update;
+        naive_sum += update;
+    }
+
+    return close(sum.value().val, 1.0 + 1.0e-10, 1.0e-15)
+        && close(sum.value().err, 1.0 + 1.0e-10, 1.0e-15)
+        && naive_sum.val == 1.0;
+}
+
+bool weighted_sum_matches_operator_expression()
+{
+    using CodomainType = std::array<double, 3>;
+    const std::array<double, 3> weights = {0.25, -1.5, 3.0};
+    const std::array<CodomainType, 4> values = {
+        CodomainType{1.0, 2.0, 3.0}, CodomainType{-0.1, 0.7, 1.0e-3},
+        CodomainType{4.0, -5.0, 6.5}, CodomainType{1.0e3, 1.0e3, 1.0e3}
+    };
+    constexpr double scale = 0.3;
+
+    const CodomainType expected = (scale*weights[0])*values[0]
+            + (scale*weights[1])*values[1] + (scale*weights[2])*values[2];
+    const double expected_scalar = (scale*weights[0])*values[0][1]
+            + (scale*weights[1])*values[1][1] + (scale*weights[2])*values[2][1];
+    const std::array<double, 4> scalar_values = {
+        values[0][1], values[1][1], values[2][1], values[3][1]
+    };
+
+    return cubage::weighted_sum(scale, weights, values) == expected
+        && cubage::weighted_sum(scale, weights, scalar_values) == expected_scalar;
+}
+
+bool gauss_kronrod_integrates_1d_gaussian_with_batched_integrand()
+{
+    using Integrator = cubage::IntervalIntegrator<double, double>;
+    constexpr double sigma = 0.01;
+    auto function = [sigma](double x)
+    {
+        const double z = x/sigma;
+        return std::exp(-0.5*z*z);
+    };
+    std::size_t eval_count = 0;
+    auto batch_function = [&](std::span<const double> x, std::span<double> y)
+    {
+        eval_count += x.size();
+        for (std::size_t i = 0; i < x.size(); ++i)
+            y[i] = function(x[i]);
+    };
+
+    constexpr double abserr = 1.0e-13;
+    constexpr double relerr = 0.0;
+    Integrator::Limits limits = Integrator::Limits{-1.0, 1.0};
+    Integrator integrator;
+    const auto& [result, _] = integrator.integrate(function, limits, abserr, relerr);
+    Integrator batch_integrator;
+    const auto& [batch_result, batch_status] = batch_integrator.integrate(
+            batch_function, limits, abserr, relerr);
+
+    return batch_status == cubage::Status::SUCCESS
+        && close(batch_result.val, result.val, abserr)
+        && eval_count == batch_integrator.func_eval_count()
+        && close(batch_result.val, sigma*std::sqrt(2.0*M_PI), abserr);
+}
+
+bool interval_integrator_integrates_in_float_and_long_double()
+{
+    auto function = [](auto x)
+    {
+        return 1/(1 + 100*x*x);
+    };
+
+    using FloatIntegrator = cubage::IntervalIntegrator<float, float>;
+    const auto& [float_result, float_status] = FloatIntegrator().integrate(
+            function, FloatIntegrator::Limits{-1.0f, 1.0f}, 1.0e-5, 0.0);
+
+    using LongDoubleIntegrator
+        = cubage::IntervalIntegrator<long double, long double>;
+    const auto& [long_double_result, long_double_status]
+        = LongDoubleIntegrator().integrate(
+            function, LongDoubleIntegrator::Limits{-1.0L, 1.0L}, 1.0e-18, 0.0);
+
+    const long double exact = 0.2L*std::atan(10.0L);
+    return float_status == cubage::Status::SUCCESS
+        && long_double_status == cubage::Status::SUCCESS
+        && std::fabs(float_result.val - exact) < 1.0e-5L
+        && std::fabs(long_double_result.val - exact) < 1.0e-18L;
+}
+
+bool hypercube_integrator_evaluates_in_float_and_accumulates_in_double()
+{
+    using FloatIntegrator
+        = cubage::HypercubeIntegrator<std::array<float, 3>, double>;
+    using DoubleIntegrator
+        = cubage::HypercubeIntegrator<std::array<double, 3>, double>;
+    auto function = [](const auto& x)
+    {
+        return std::exp(-double(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]));
+    };
+    auto batch_function = [&](
+        std::span<const std::array<float, 3>> x, std::span<double> y)
+    {
+        for (std::size_t i = 0; i < x.size(); ++i)
+            y[i] = function(x[i]);
+    };
+
+    constexpr double abserr = 1.0e-7;
+    constexpr double relerr = 0.0;
+    const FloatIntegrator::Limits float_limits{
+        {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}
+    };
+    const auto& [result, status] = FloatIntegrator().integrate(
+            function, float_limits, abserr, relerr);
+    const auto& [batch_result, batch_status] = FloatIntegrator().integrate(
+            batch_function, float_limits, abserr, relerr);
+    const auto& [parallel_result, parallel_status] = FloatIntegrator(2).integrate(
+            function, float_limits, abserr, relerr);
+    const auto& [double_result, double_status] = DoubleIntegrator().integrate(
+            function, DoubleIntegrator::Limits{
+                {-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}
+            }, abserr, relerr);
+    std::cout << result.val << '\n';
+    std::cout << result.err << '\n';
+
+    const double exact = std::pow(std::sqrt(M_PI)*std::erf(1.0), 3);
+    return status == cubage::Status::SUCCESS
+        && double_status == cubage::Status::SUCCESS
+        && batch_result.val == result.val && batch_status == status
+        && parallel_status == status
+        && close(result.val, exact, 1.0e-6)
+        && close(parallel_result.val, exact, 1.0e-6)
+        && close(result.val, double_result.val, 1.0e-6)
+        && FloatIntegrator::region_bytes < DoubleIntegrator::region_bytes;
+}
+
+template <typename FloatIntegrator, typename DoubleIntegrator>
+bool float_domain_matches_double_domain()
+{
+    auto function = [](const auto& x)
+    {
+        return std::exp(-double(x[0]*x[0] + x[1]*x[1] + x[2]*x[2]));
+    };
+
+    constexpr double abserr = 1.0e-7;
+    constexpr double relerr = 0.0;
+    const auto& [result, status] = FloatIntegrator().integrate(
+            function, typename FloatIntegrator::Limits{
+                {-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}
+            }, abserr, relerr);
+    const auto& [double_result, double_status] = DoubleIntegrator().integrate(
+            function, typename DoubleIntegrator::Limits{
+                {-1.0, -1.0, -1.0}, {1.0, 1.0, 1.0}
+            }, abserr, relerr);
+
+    const double exact = std::pow(std::sqrt(M_PI)*std::erf(1.0), 3);
+    return status == cubage::Status::SUCCESS
+        && double_status == cubage::Status::SUCCESS
+        && close(result.val, exact, 1.0e-6)
+        && close(result.val, double_result.val, 1.0e-6);
+}
 
 int main()
 {
     assert(gauss_kronrod_integrates_1d_gaussian());
+    assert(romberg_integrates_1d_gaussian_with_counted_evaluations());
     assert(genz_malik_integrates_2d_gaussian());
     assert(genz_malik_integrates_3d_gaussian());
+    assert(genz_malik_converges_to_relative_tolerance_for_negative_integral());
+    assert(nested_genz_malik_integrates_3d_gaussian_with_counted_evaluations());
+    assert(genz_malik_integrates_3d_gaussian_with_batched_integrand());
+    assert(parallel_genz_malik_is_independent_of_thread_count());
+    assert(parallel_genz_malik_evaluates_regions_in_parallel_in_16d());
+    assert(copied_integrator_refines_like_original());
+    assert(stored_region_results_sum_to_integral());
+    assert(refined_integral_matches_direct_integral());
+    assert(restored_checkpoint_continues_integration());
+    assert(failed_checkpoint_load_keeps_state());
+    assert(genz_malik_integrates_2d_gaussian_with_queue<cubage::QuaternaryHeapQueue>());
+    assert(genz_malik_integrates_2d_gaussian_with_queue<cubage::BucketQueue>());
+    assert(genz_malik_integrates_2d_gaussian_with_queue<cubage::LazySortQueue<>>());
+    assert(batch_integrates_parametrized_gaussians_independently());
+    assert(batch_rethrows_failure_of_one_integrand());
+    assert(componentwise_norm_retires_converged_components());
+    assert(dynamic_hypercube_matches_fixed_dimension<3>());
+    assert(dynamic_hypercube_matches_fixed_dimension<7>());
+    assert(higher_degree_rules_need_fewer_evaluations());
+    assert(null_rule_error_needs_fewer_regions_for_3d_gaussian());
+    assert(simplex_integrator_integrates_3d_gaussian_over_triangulated_cube());
+    assert(integrators_sharing_memory_pool_match_default_allocator());
+    assert(memory_limit_retires_negligible_regions());
+    assert(compensated_sum_keeps_small_updates());
+    assert(weighted_sum_matches_operator_expression());
+    assert(gauss_kronrod_integrates_1d_gaussian_with_batched_integrand());
+    assert(interval_integrator_integrates_in_float_and_long_double());
+    assert(hypercube_integrator_evaluates_in_float_and_accumulates_in_double());
+    assert((float_domain_matches_double_domain<
+            cubage::NestedHypercubeIntegrator<std::array<float, 3>, double>,
+            cubage::NestedHypercubeIntegrator<std::array<double, 3>, double>>()));
+    assert((float_domain_matches_double_domain<
+            cubage::HypercubeIntegratorOfDegree<std::array<float, 3>, double, 9>,
+            cubage::HypercubeIntegratorOfDegree<std::array<double, 3>, double, 9>>()));
+    assert((float_domain_matches_double_domain<
+            cubage::HypercubeIntegratorOfDegree<std::array<float, 3>, double, 11>,
+            cubage::HypercubeIntegratorOfDegree<std::array<double, 3>, double, 11>>()));
 }
\ No newline at end of file
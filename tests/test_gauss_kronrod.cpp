@@ -21,6 +21,8 @@ SOFTWARE.
 */
 #include <iostream>
 #include <cmath>
+#include <array>
+#include <span>
 
 #include "gauss_kronrod.hpp"
 
@@ -202,12 +204,109 @@ gauss_kronrod_61_integrates_91st_degree_polynomial_exactly()
     return close(res.val, 35771317.0/52689780.0, 1.0e-13);
 }
 
+constexpr bool
+gauss_kronrod_multi_interval_variant_matches_single_intervals()
+{
+    using Rule = cubage::GaussKronrod<double, double, 21>;
+    constexpr std::array<cubage::Interval<double>, 5> limits = {
+        cubage::Interval<double>{0.0, 1.0}, cubage::Interval<double>{-2.0, 0.5},
+        cubage::Interval<double>{0.5, 0.75}, cubage::Interval<double>{1.0, 4.0},
+        cubage::Interval<double>{-0.125, 0.0}
+    };
+
+    auto function = [](double x) { return 1.0/(1.0 + x*x); };
+    auto batch_function = [&](std::span<const double> x, std::span<double> y)
+    {
+        for (std::size_t i = 0; i < x.size(); ++i)
+            y[i] = function(x[i]);
+    };
+
+    std::array<Rule::ReturnType, limits.size()> results{};
+    std::array<Rule::ReturnType, limits.size()> batch_results{};
+    Rule::integrate(function, std::span(limits), std::span(results));
+    Rule::integrate(batch_function, std::span(limits), std::span(batch_results));
+    for (std::size_t i = 0; i < limits.size(); ++i)
+    {
+        const auto res = Rule::integrate(function, limits[i]);
+        const auto batch_res = Rule::integrate(batch_function, limits[i]);
+        if (results[i].val != res.val || results[i].err != res.err
+                || batch_results[i].val != res.val
+                || batch_results[i].err != res.err
+                || batch_res.val != res.val || batch_res.err != res.err)
+            return false;
+    }
+    return true;
+}
+
+constexpr bool
+gauss_kronrod_multi_interval_variant_handles_any_number_of_intervals()
+{
+    using Rule = cubage::GaussKronrod<double, double, 15>;
+    constexpr std::size_t count = 2*Rule::batch_size + 3;
+    std::array<cubage::Interval<double>, count> limits{};
+    for (std::size_t i = 0; i < count; ++i)
+        limits[i] = cubage::Interval<double>{double(i), double(i) + 0.5};
+
+    auto function = [](double x) { return 1.0/(1.0 + x*x); };
+
+    std::array<Rule::ReturnType, count> results{};
+    Rule::integrate(function, std::span<const cubage::Interval<double>>(),
+            std::span(results));
+    for (const auto& res : results)
+    {
+        if (res.val != 0.0 || res.err != 0.0)
+            return false;
+    }
+
+    Rule::integrate(function, std::span(limits), std::span(results));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto res = Rule::integrate(function, limits[i]);
+        if (results[i].val != res.val || results[i].err != res.err)
+            return false;
+    }
+    return true;
+}
+
+constexpr bool
+gauss_kronrod_tables_are_accurate_in_all_precisions()
+{
+    auto polynomial = [](auto x)
+    {
+        const auto x2 = x*x;
+        const auto x4 = x2*x2;
+        const auto x8 = x4*x4;
+        const auto x11 = x8*x2*x;
+        return x11*x11 + x8 + x;
+    };
+    constexpr long double exact = 1.0L/23.0L + 1.0L/9.0L + 1.0L/2.0L;
+
+    const auto res_float = cubage::GaussKronrod<float, float, 15>::integrate(
+            polynomial, cubage::Interval<float>{0.0f, 1.0f});
+    const auto res_double = cubage::GaussKronrod<double, double, 15>::integrate(
+            polynomial, cubage::Interval<double>{0.0, 1.0});
+    const auto res_long_double
+        = cubage::GaussKronrod<long double, long double, 15>::integrate(
+            polynomial, cubage::Interval<long double>{0.0L, 1.0L});
+
+    auto error = [&](long double val)
+    {
+        return (val > exact) ? val - exact : exact - val;
+    };
+    return error(res_float.val) < 4.0e-7L
+        && error(res_double.val) < 4.0e-16L
+        && error(res_long_double.val) < 4.0e-19L;
+}
+
 static_assert(gauss_kronrod_15_integrates_22nd_degree_polynomial_exactly());
 static_assert(gauss_kronrod_21_integrates_31st_degree_polynomial_exactly());
 static_assert(gauss_kronrod_31_integrates_46th_degree_polynomial_exactly());
 static_assert(gauss_kronrod_41_integrates_61st_degree_polynomial_exactly());
 static_assert(gauss_kronrod_51_integrates_76th_degree_polynomial_exactly());
 static_assert(gauss_kronrod_61_integrates_91st_degree_polynomial_exactly());
+static_assert(gauss_kronrod_multi_interval_variant_matches_single_intervals());
+static_assert(gauss_kronrod_multi_interval_variant_handles_any_number_of_intervals());
+static_assert(gauss_kronrod_tables_are_accurate_in_all_precisions());
 
 int main()
 {
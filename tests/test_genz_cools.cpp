@@ -0,0 +1,151 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#include <iostream>
+#include <cmath>
+
+#include "array_arithmetic.hpp"
+#include "hypercube_integrator.hpp"
+
+constexpr bool close(double a, double b, double tol)
+{
+    return std::fabs(a - b) < tol;
+}
+
+using Point = std::array<double, 3>;
+
+// Simplex 2*{0, e_0, e_1, e_2} shifted by `origin`, on which the integral of
+// the monomial x^a in the shifted coordinates is 2^(3 + |a|) a!/(3 + |a|)!.
+constexpr Point origin = {1.0, -1.0, 0.5};
+constexpr cubage::Simplex<Point> shifted_simplex = {{
+    origin,
+    origin + Point{2.0, 0.0, 0.0},
+    origin + Point{0.0, 2.0, 0.0},
+    origin + Point{0.0, 0.0, 2.0}
+}};
+
+constexpr bool
+constant_unity_function_integrates_to_volume()
+{
+    using Rule = cubage::GenzCools<Point, double>;
+    auto unity_function = []([[maybe_unused]] const Point& x){ return 1.0; };
+    const auto res = Rule::integrate(unity_function, shifted_simplex);
+    return close(res.val, 4.0/3.0, 1.0e-14);
+}
+
+constexpr bool
+third_degree_polynomial_integrates_exactly()
+{
+    using Rule = cubage::GenzCools<Point, double, 3>;
+    auto polynomial = [](const Point& x)
+    {
+        const Point y = x - origin;
+        return y[0]*y[0]*y[1];
+    };
+    const auto res = Rule::integrate(polynomial, shifted_simplex);
+    return close(res.val, 64.0*2.0/720.0, 1.0e-14);
+}
+
+constexpr bool
+fifth_degree_polynomial_integrates_exactly()
+{
+    using Rule = cubage::GenzCools<Point, double, 5>;
+    auto polynomial = [](const Point& x)
+    {
+        const Point y = x - origin;
+        return y[0]*y[0]*y[1]*y[1]*y[2];
+    };
+    const auto res = Rule::integrate(polynomial, shifted_simplex);
+    return close(res.val, 256.0*4.0/40320.0, 1.0e-14);
+}
+
+constexpr bool
+seventh_degree_polynomial_integrates_exactly()
+{
+    using Rule = cubage::GenzCools<Point, double, 7>;
+    auto polynomial = [](const Point& x)
+    {
+        const Point y = x - origin;
+        return y[0]*y[0]*y[0]*y[1]*y[1]*y[2]*y[2];
+    };
+    const auto res = Rule::integrate(polynomial, shifted_simplex);
+    return close(res.val, 1024.0*24.0/3628800.0, 1.0e-14);
+}
+
+constexpr bool
+ninth_degree_polynomial_integrates_exactly()
+{
+    using Rule = cubage::GenzCools<Point, double, 9>;
+    auto polynomial = [](const Point& x)
+    {
+        const Point y = x - origin;
+        return y[0]*y[0]*y[0]*y[1]*y[1]*y[2]*y[2]*y[2]*y[2];
+    };
+    const auto res = Rule::integrate(polynomial, shifted_simplex);
+    return close(res.val, 4096.0*288.0/479001600.0, 1.0e-14);
+}
+
+constexpr bool
+error_of_linear_function_is_zero()
+{
+    using Rule = cubage::GenzCools<Point, double, 9>;
+    auto linear_function = [](const Point& x)
+    {
+        return 1.0 + x[0] - 2.0*x[1] + 3.0*x[2];
+    };
+    const auto res = Rule::integrate(linear_function, shifted_simplex);
+    return close(res.err, 0.0, 1.0e-13);
+}
+
+constexpr bool
+vector_valued_integrand_is_integrated_componentwise()
+{
+    using Rule = cubage::GenzCools<Point, std::array<double, 2>>;
+    using ScalarRule = cubage::GenzCools<Point, double>;
+    auto first = [](const Point& x){ return std::cos(x[0]*x[1]); };
+    auto second = [](const Point& x){ return std::exp(x[2]); };
+    auto function = [&](const Point& x)
+    {
+        return std::array<double, 2>{first(x), second(x)};
+    };
+    const auto res = Rule::integrate(function, shifted_simplex);
+    const auto first_res = ScalarRule::integrate(first, shifted_simplex);
+    const auto second_res = ScalarRule::integrate(second, shifted_simplex);
+    return res.val[0] == first_res.val && res.err[0] == first_res.err
+        && res.val[1] == second_res.val && res.err[1] == second_res.err;
+}
+
+static_assert(cubage::SubdivisionIntegrable<
+        cubage::IntegrationSimplex<cubage::GenzCools<Point, double>>>);
+static_assert(cubage::GenzCools<Point, double, 3>::points_count() == 5);
+static_assert(cubage::GenzCools<Point, double, 9>::points_count() == 70);
+static_assert(constant_unity_function_integrates_to_volume());
+static_assert(third_degree_polynomial_integrates_exactly());
+static_assert(fifth_degree_polynomial_integrates_exactly());
+static_assert(seventh_degree_polynomial_integrates_exactly());
+static_assert(ninth_degree_polynomial_integrates_exactly());
+static_assert(error_of_linear_function_is_zero());
+static_assert(vector_valued_integrand_is_integrated_componentwise());
+
+int main()
+{
+    
+}
\ No newline at end of file
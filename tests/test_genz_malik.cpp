@@ -20,9 +20,12 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <iostream>
+#include <cassert>
 
 #include "array_arithmetic.hpp"
 #include "genz_malik.hpp"
+#include "nested_genz_malik.hpp"
+#include "fully_symmetric.hpp"
 
 
 constexpr bool close(double a, double b, double tol)
@@ -33,10 +36,9 @@ constexpr bool close(double a, double b, double tol)
 constexpr double upow(double x, std::size_t n)
 {
     double res = 1.0;
-    const std::array<double, 2> mult = {1.0, x};
     while (1)
     {
-        res *= mult[n & 1];     // if n is odd, multiply result by x
+        if (n & 1) res *= x;    // if n is odd, multiply result by x
         n >>= 1;                // Divide n by 2
         if (!n) break;          // Stop iteration when n reaches 0
         x *= x;                 // Square x
@@ -177,6 +179,385 @@ subdiv_axis_is_in_nonconst_direction()
     return axis == 2;
 }
 
+constexpr bool
+batched_integrand_gives_same_result_as_pointwise_integrand()
+{
+    using Rule = cubage::GenzMalikD7<std::array<double, 3>, double>;
+    constexpr cubage::Box<std::array<double, 3>> limits = {
+        std::array<double, 3>{0.0, 0.0, 0.0},
+        std::array<double, 3>{1.0, 1.0, 1.0}
+    };
+    auto polynomial = [](std::array<double, 3> x)
+    {
+        return x[0]*x[0]*x[0]*x[0]*x[0]*x[0]*x[0]
+            + x[0]*x[0]*x[0]*x[1]*x[1]*x[1]*x[2]
+            + x[0]*x[0]*x[2]*x[2]
+            + x[0]*x[1]*x[2]
+            + std::cos(x[1]);
+    };
+    auto batched_polynomial = [&](
+        std::span<const std::array<double, 3>> x, std::span<double> y)
+    {
+        for (std::size_t i = 0; i < x.size(); ++i)
+            y[i] = polynomial(x[i]);
+    };
+    const auto& [res, axis] = Rule::integrate(polynomial, limits);
+    const auto& [batched_res, batched_axis]
+        = Rule::integrate(batched_polynomial, limits);
+    return close(res.val, batched_res.val, 1.0e-13)
+        && close(res.err, batched_res.err, 1.0e-13)
+        && axis == batched_axis;
+}
+
+bool batched_integrand_in_12d_is_called_in_bounded_chunks()
+{
+    constexpr std::size_t ndim = 12;
+    using Domain = std::array<double, ndim>;
+    using Rule = cubage::GenzMalikD7<Domain, double>;
+    Domain xmin{};
+    Domain xmax{};
+    xmax.fill(1.0);
+    const cubage::Box<Domain> limits = {xmin, xmax};
+    auto function = [](const Domain& x)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < ndim; ++i)
+            sum += double(i + 1)*x[i];
+        return std::cos(sum);
+    };
+
+    std::size_t call_count = 0;
+    std::size_t point_count = 0;
+    std::size_t max_call_size = 0;
+    auto batched_function = [&](std::span<const Domain> x, std::span<double> y)
+    {
+        ++call_count;
+        point_count += x.size();
+        max_call_size = std::max(max_call_size, x.size());
+        for (std::size_t i = 0; i < x.size(); ++i)
+            y[i] = function(x[i]);
+    };
+
+    const auto& [res, axis] = Rule::integrate(function, limits);
+    const auto& [batched_res, batched_axis]
+        = Rule::integrate(batched_function, limits);
+    return close(res.val, batched_res.val, 1.0e-13)
+        && close(res.err, batched_res.err, 1.0e-13)
+        && axis == batched_axis
+        && point_count == Rule::points_count()
+        && call_count > 1
+        && max_call_size*sizeof(Domain) <= (std::size_t(1) << 15);
+}
+
+constexpr bool points_count_in_40d_exceeds_32_bits()
+{
+    using Rule = cubage::GenzMalikD7<std::array<double, 40>, double>;
+    return Rule::points_count() == (std::size_t(1) << 40) + 1 + 2*40*41;
+}
+
+bool parallel_vertex_sum_is_independent_of_thread_count()
+{
+    constexpr std::size_t ndim = 12;
+    using Rule = cubage::GenzMalikD7<std::array<double, ndim>, double>;
+    std::array<double, ndim> xmin{};
+    std::array<double, ndim> xmax{};
+    xmax.fill(1.0);
+    const cubage::Box<std::array<double, ndim>> limits = {xmin, xmax};
+    auto function = [](const std::array<double, ndim>& x)
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < ndim; ++i)
+            sum += double(i + 1)*x[i];
+        return std::cos(sum);
+    };
+
+    cubage::ThreadPool serial_pool(1);
+    cubage::ThreadPool parallel_pool(4);
+    const auto& [res, axis] = Rule::integrate(function, limits);
+    const auto& [serial_res, serial_axis]
+        = Rule::integrate(function, limits, serial_pool);
+    const auto& [parallel_res, parallel_axis]
+        = Rule::integrate(function, limits, parallel_pool);
+    return close(res.val, parallel_res.val, 1.0e-13)
+        && close(res.err, parallel_res.err, 1.0e-13)
+        && axis == parallel_axis
+        && serial_res.val == parallel_res.val
+        && serial_res.err == parallel_res.err;
+}
+
+constexpr bool nested_rule_integrates_seventh_degree_polynomial_exactly()
+{
+    using Rule = cubage::NestedGenzMalikD7<std::array<double, 3>, double>;
+    constexpr cubage::Box<std::array<double, 3>> limits = {
+        std::array<double, 3>{0.0, -1.0, 0.5},
+        std::array<double, 3>{1.0, 2.0, 1.5}
+    };
+    auto polynomial = [](std::array<double, 3> x)
+    {
+        return x[0]*x[0]*x[0]*x[0]*x[0]*x[0]*x[0]
+            + x[0]*x[0]*x[1]*x[1]*x[2]*x[2]
+            + x[1]*x[1]*x[1]*x[1]*x[1]*x[1]
+            + x[0]*x[1]*x[2] + 1.0;
+    };
+    // integrals of the terms over the box
+    constexpr double expected
+        = (1.0/8.0)*3.0*1.0
+        + (1.0/3.0)*3.0*((1.5*1.5*1.5 - 0.5*0.5*0.5)/3.0)
+        + 1.0*((128.0 + 1.0)/7.0)*1.0
+        + 0.5*1.5*1.0
+        + 3.0;
+    const auto& [res, axis] = Rule::integrate(polynomial, limits);
+    return close(res.val, expected, 1.0e-12);
+}
+
+constexpr bool nested_rule_reuses_parent_values_exactly()
+{
+    using Rule = cubage::NestedGenzMalikD7<std::array<double, 3>, double>;
+    using Region = Rule::RegionType;
+    auto function = [](std::array<double, 3> x)
+    {
+        return std::cos(x[0] + 2.0*x[1])*(1.0 + x[2]*x[2]) + x[0]*x[1]*x[2];
+    };
+
+    Region parent(
+        std::array<double, 3>{0.0, 0.0, 0.0},
+        std::array<double, 3>{1.0, 2.0, 0.5});
+    const auto parent_res = parent.integrate<Rule>(function);
+    auto [first, second] = parent.subdivide();
+    const auto first_res = first.integrate<Rule>(function);
+    const auto second_res = second.integrate<Rule>(function);
+
+    const auto& [fresh_first_res, first_axis]
+        = Rule::integrate(function, first.limits());
+    const auto& [fresh_second_res, second_axis]
+        = Rule::integrate(function, second.limits());
+    return close(first_res.val, fresh_first_res.val, 1.0e-15)
+        && close(first_res.err, fresh_first_res.err, 1.0e-15)
+        && close(second_res.val, fresh_second_res.val, 1.0e-15)
+        && close(second_res.err, fresh_second_res.err, 1.0e-15)
+        && close(first_res.val + second_res.val, parent_res.val, 1.0e-3);
+}
+
+constexpr bool ninth_degree_polynomial_integrates_exactly()
+{
+    using Rule = cubage::FullySymmetricRule<std::array<double, 3>, double, 9>;
+    constexpr cubage::Box<std::array<double, 3>> limits = {
+        std::array<double, 3>{0.0, 0.0, 0.0},
+        std::array<double, 3>{1.0, 1.0, 1.0}
+    };
+    auto polynomial = [](std::array<double, 3> x)
+    {
+        return upow(x[0], 9)
+            + upow(x[0], 3)*upow(x[1], 3)*upow(x[2], 3)
+            + x[0]*x[0]*x[1]*x[1]*upow(x[2], 4)
+            + x[0]*x[1]*x[2];
+    };
+    const auto& [res, axis] = Rule::integrate(polynomial, limits);
+    return close(res.val, 1.0/10.0 + 1.0/64.0 + 1.0/45.0 + 1.0/8.0, 1.0e-13);
+}
+
+constexpr bool error_of_seventh_degree_polynomial_with_ninth_degree_rule_is_zero()
+{
+    using Rule = cubage::FullySymmetricRule<std::array<double, 3>, double, 9>;
+    constexpr cubage::Box<std::array<double, 3>> limits = {
+        std::array<double, 3>{0.0, 0.0, 0.0},
+        std::array<double, 3>{1.0, 1.0, 1.0}
+    };
+    auto polynomial = [](std::array<double, 3> x)
+    {
+        return upow(x[0], 7)
+            + upow(x[0], 3)*upow(x[1], 3)*x[2]
+            + x[0]*x[0]*x[2]*x[2]
+            + x[0]*x[1]*x[2];
+    };
+    const auto& [res, axis] = Rule::integrate(polynomial, limits);
+    return close(res.err, 0.0, 1.0e-13);
+}
+
+constexpr bool eleventh_degree_polynomial_integrates_exactly()
+{
+    using Rule = cubage::FullySymmetricRule<std::array<double, 4>, double, 11>;
+    constexpr cubage::Box<std::array<double, 4>> limits = {
+        std::array<double, 4>{0.0, 0.0, 0.0, 0.0},
+        std::array<double, 4>{1.0, 1.0, 1.0, 1.0}
+    };
+    auto polynomial = [](std::array<double, 4> x)
+    {
+        return upow(x[0], 11)
+            + upow(x[0], 3)*upow(x[1], 3)*upow(x[2], 3)*x[3]*x[3]
+            + x[1]*x[1]*x[2]*x[2]*upow(x[3], 6)
+            + 1.0;
+    };
+    const auto& [res, axis] = Rule::integrate(polynomial, limits);
+    return close(res.val, 1.0/12.0 + 1.0/192.0 + 1.0/63.0 + 1.0, 1.0e-13);
+}
+
+constexpr bool subdiv_axis_of_eleventh_degree_rule_is_in_nonconst_direction()
+{
+    using Rule = cubage::FullySymmetricRule<std::array<double, 4>, double, 11>;
+    constexpr cubage::Box<std::array<double, 4>> limits = {
+        std::array<double, 4>{0.0, 0.0, 0.0, 0.0},
+        std::array<double, 4>{1.0, 1.0, 1.0, 1.0}
+    };
+    auto function = [](std::array<double, 4> x)
+    {
+        return std::cos(4.0*x[1]);
+    };
+    const auto& [res, axis] = Rule::integrate(function, limits);
+    return axis == 1;
+}
+
+template <std::size_t Degree, std::size_t Ndim>
+bool fully_symmetric_rule_integrates_polynomial_exactly_in_dimension()
+{
+    using Domain = std::array<double, Ndim>;
+    using Rule = cubage::FullySymmetricRule<Domain, double, Degree>;
+    Domain xmin{};
+    Domain xmax{};
+    xmax.fill(1.0);
+    const cubage::Box<Domain> limits = {xmin, xmax};
+    auto polynomial = [](const Domain& x)
+    {
+        double res = x[0]*x[0]*upow(x[Ndim - 1], Degree - 2);
+        for (std::size_t i = 0; i < Ndim; ++i)
+            res += upow(x[i], Degree);
+        return res;
+    };
+    const double exact
+        = double(Ndim)/double(Degree + 1) + 1.0/double(3*(Degree - 1));
+    const auto& [res, axis] = Rule::integrate(polynomial, limits);
+    return close(res.val, exact, 1.0e-12*exact);
+}
+
+template <std::size_t Degree, std::size_t MaxNdim>
+bool fully_symmetric_rule_integrates_polynomials_exactly_up_to_dimension()
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        return (fully_symmetric_rule_integrates_polynomial_exactly_in_dimension<
+                Degree, I + 2>() && ...);
+    }(std::make_index_sequence<MaxNdim - 1>{});
+}
+
+constexpr bool degree_seven_hypercube_rule_is_genz_malik()
+{
+    using Domain = std::array<double, 3>;
+    return std::is_same_v<
+            cubage::HypercubeRule<Domain, double, 7>,
+            cubage::GenzMalikD7<Domain, double>>
+        && std::is_same_v<
+            cubage::HypercubeRule<Domain, double, 11>,
+            cubage::FullySymmetricRule<Domain, double, 11>>;
+}
+
+constexpr bool null_rule_error_of_linear_function_is_zero()
+{
+    using Rule = cubage::GenzMalikD7<
+            std::array<double, 3>, double, cubage::NullRuleError>;
+    constexpr cubage::Box<std::array<double, 3>> limits = {
+        std::array<double, 3>{0.0, 0.0, 0.0},
+        std::array<double, 3>{1.0, 2.0, 3.0}
+    };
+    auto linear = [](std::array<double, 3> x)
+    {
+        return 1.0 + x[0] - 2.0*x[1] + 3.0*x[2];
+    };
+    const auto& [res, axis] = Rule::integrate(linear, limits);
+    return close(res.val, 6.0*(1.0 + 0.5 - 2.0 + 4.5), 1.0e-12)
+        && close(res.err, 0.0, 1.0e-12);
+}
+
+/*
+    The null rules of degree 3 and 1 do not vanish for monomials of degree 4
+    and 5, which the rule integrates exactly, so the error estimate must not
+    follow them.
+*/
+template <std::size_t NDIM>
+bool null_rule_error_of_low_degree_monomials_is_negligible_in_dimension()
+{
+    using Domain = std::array<double, NDIM>;
+    using Rule = cubage::GenzMalikD7<Domain, double, cubage::NullRuleError>;
+    Domain lower;
+    Domain upper;
+    Domain shifted_lower;
+    Domain shifted_upper;
+    lower.fill(-1.0);
+    upper.fill(1.0);
+    shifted_lower.fill(-0.7);
+    shifted_upper.fill(1.5);
+    const std::array<cubage::Box<Domain>, 2> boxes = {
+        cubage::Box<Domain>{lower, upper},
+        cubage::Box<Domain>{shifted_lower, shifted_upper}
+    };
+
+    bool negligible = true;
+    for (const auto& limits : boxes)
+    {
+        for (std::size_t a = 0; a <= 5; ++a)
+        {
+            for (std::size_t b = 0; a + b <= 5; ++b)
+            {
+                auto monomial = [a, b](const Domain& x)
+                {
+                    double res = 1.0;
+                    for (std::size_t i = 0; i < a; ++i) res *= x[0];
+                    for (std::size_t i = 0; i < b; ++i) res *= x[NDIM - 1];
+                    return res;
+                };
+                const auto& [res, axis] = Rule::integrate(monomial, limits);
+                negligible = negligible
+                    && res.err <= 1.0e-12*limits.volume();
+            }
+        }
+    }
+    return negligible;
+}
+
+template <std::size_t MaxNdim>
+bool null_rule_error_of_low_degree_monomials_is_negligible_up_to_dimension()
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        return (null_rule_error_of_low_degree_monomials_is_negligible_in_dimension<
+                I + 2>() && ...);
+    }(std::make_index_sequence<MaxNdim - 1>{});
+}
+
+constexpr bool null_rule_error_does_not_change_integral()
+{
+    using Rule = cubage::GenzMalikD7<std::array<double, 4>, double>;
+    using NullRule = cubage::GenzMalikD7<
+            std::array<double, 4>, double, cubage::NullRuleError>;
+    constexpr cubage::Box<std::array<double, 4>> limits = {
+        std::array<double, 4>{0.0, 0.0, 0.0, 0.0},
+        std::array<double, 4>{1.0, 1.0, 1.0, 1.0}
+    };
+    auto function = [](std::array<double, 4> x)
+    {
+        return std::cos(x[0] + 2.0*x[1] - x[2]*x[3]);
+    };
+    const auto& [res, axis] = Rule::integrate(function, limits);
+    const auto& [null_res, null_axis] = NullRule::integrate(function, limits);
+    return res.val == null_res.val && axis == null_axis && null_res.err > 0.0;
+}
+
+constexpr bool null_rule_error_estimate_distinguishes_regimes()
+{
+    constexpr double min_ratio = 1.0/8.0;
+    // not asymptotic: the largest null rule with the safety factor
+    const double non_asymptotic = cubage::null_rule_error_estimate(
+            std::array<double, 3>{2.0e-3, 1.0e-3, 4.0e-3}, min_ratio);
+    // slow decay: the first null rule times the ratio
+    const double slow = cubage::null_rule_error_estimate(
+            std::array<double, 3>{3.0e-4, 4.0e-4, 1.0e-3}, min_ratio);
+    // fast decay, bounded by the minimum ratio
+    const double fast = cubage::null_rule_error_estimate(
+            std::array<double, 3>{1.0e-9, 1.0e-6, 1.0e-3}, min_ratio);
+    return close(non_asymptotic, 4.0e-2, 1.0e-15)
+        && close(slow, 10.0*0.75*3.0e-4, 1.0e-15)
+        && close(fast, 20.0*min_ratio*min_ratio*1.0e-9, 1.0e-20);
+}
+
 static_assert(constant_unity_function_in_3d_null_box_integrates_to_zero());
 static_assert(constant_zero_function_in_3d_unit_box_integrates_to_zero());
 static_assert(constant_unity_function_in_3d_unit_box_integrates_to_unity());
@@ -185,8 +566,24 @@ static_assert(radius_squared_in_3d_unit_box_integrates_to_unity());
 static_assert(seventh_degree_polynomial_integrates_exactly());
 static_assert(error_of_fift_degree_polynomial_integral_is_zero());
 static_assert(subdiv_axis_is_in_nonconst_direction());
+static_assert(batched_integrand_gives_same_result_as_pointwise_integrand());
+static_assert(points_count_in_40d_exceeds_32_bits());
+static_assert(nested_rule_integrates_seventh_degree_polynomial_exactly());
+static_assert(nested_rule_reuses_parent_values_exactly());
+static_assert(ninth_degree_polynomial_integrates_exactly());
+static_assert(error_of_seventh_degree_polynomial_with_ninth_degree_rule_is_zero());
+static_assert(eleventh_degree_polynomial_integrates_exactly());
+static_assert(subdiv_axis_of_eleventh_degree_rule_is_in_nonconst_direction());
+static_assert(degree_seven_hypercube_rule_is_genz_malik());
+static_assert(null_rule_error_of_linear_function_is_zero());
+static_assert(null_rule_error_does_not_change_integral());
+static_assert(null_rule_error_estimate_distinguishes_regimes());
 
 int main()
 {
-    
+    assert(batched_integrand_in_12d_is_called_in_bounded_chunks());
+    assert(parallel_vertex_sum_is_independent_of_thread_count());
+    assert((fully_symmetric_rule_integrates_polynomials_exactly_up_to_dimension<9, 17>()));
+    assert((fully_symmetric_rule_integrates_polynomials_exactly_up_to_dimension<11, 8>()));
+    assert(null_rule_error_of_low_degree_monomials_is_negligible_up_to_dimension<10>());
 }
\ No newline at end of file
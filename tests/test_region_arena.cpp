@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#include <cassert>
+#include <sstream>
+#include <memory_resource>
+#include <array>
+
+#include "region_arena.hpp"
+
+using Element = std::array<double, 6>;
+
+bool growth_does_not_move_elements()
+{
+    cubage::RegionArena<Element> arena;
+    arena.push_back(Element{1.0});
+    const Element* first = &arena[0];
+    for (std::size_t i = 1; i < 10*arena.chunk_size; ++i)
+        arena.push_back(Element{double(i)});
+
+    return &arena[0] == first && arena.size() == 10*arena.chunk_size
+        && arena[arena.size() - 1][0] == double(arena.size() - 1);
+}
+
+bool clear_keeps_chunks_for_reuse()
+{
+    std::pmr::monotonic_buffer_resource resource;
+    cubage::RegionArena<Element, std::pmr::polymorphic_allocator<Element>>
+    arena(&resource);
+    for (std::size_t i = 0; i < 3*arena.chunk_size; ++i)
+        arena.push_back(Element{double(i)});
+    const std::size_t capacity = arena.capacity();
+    const Element* first = &arena[0];
+
+    arena.clear();
+    for (std::size_t i = 0; i < 3*arena.chunk_size; ++i)
+        arena.push_back(Element{double(i)});
+
+    return arena.capacity() == capacity && &arena[0] == first;
+}
+
+bool chunks_cover_all_elements_in_order()
+{
+    cubage::RegionArena<double, std::allocator<double>, 64> arena;
+    for (std::size_t i = 0; i < 100; ++i)
+        arena.push_back(double(i));
+
+    std::size_t count = 0;
+    bool in_order = true;
+    arena.for_each_chunk([&](std::span<const double> chunk)
+    {
+        for (const double x : chunk)
+            in_order = in_order && x == double(count++);
+    });
+    return in_order && count == arena.size();
+}
+
+bool checkpoint_round_trip_restores_elements()
+{
+    cubage::RegionArena<Element, std::allocator<Element>, 1024> arena;
+    for (std::size_t i = 0; i < 100; ++i)
+        arena.push_back(Element{double(i), -double(i)});
+
+    std::stringstream stream;
+    cubage::write_binary(stream, arena);
+    cubage::RegionArena<Element, std::allocator<Element>, 1024> restored;
+    cubage::read_binary(stream, restored);
+
+    bool equal = restored.size() == arena.size();
+    for (std::size_t i = 0; equal && i < arena.size(); ++i)
+        equal = restored[i] == arena[i];
+    return equal;
+}
+
+bool read_rejects_count_beyond_data()
+{
+    // A count of 2^60 elements followed by a single element.
+    std::stringstream stream;
+    cubage::write_binary(stream, std::uint64_t(1) << 60);
+    cubage::write_binary(stream, Element{1.0, 2.0});
+    const std::string data = stream.str();
+
+    bool arena_rejects = false;
+    try
+    {
+        std::stringstream in(data);
+        cubage::RegionArena<Element, std::allocator<Element>, 1024> arena;
+        cubage::read_binary(in, arena);
+    }
+    catch (const std::runtime_error&)
+    {
+        arena_rejects = true;
+    }
+
+    bool vector_rejects = false;
+    try
+    {
+        std::stringstream in(data);
+        std::vector<Element> values;
+        cubage::read_binary(in, values);
+    }
+    catch (const std::runtime_error&)
+    {
+        vector_rejects = true;
+    }
+
+    return arena_rejects && vector_rejects;
+}
+
+bool copy_has_equal_elements_in_own_chunks()
+{
+    cubage::RegionArena<Element, std::allocator<Element>, 1024> arena;
+    for (std::size_t i = 0; i < 100; ++i)
+        arena.push_back(Element{double(i)});
+
+    cubage::RegionArena<Element, std::allocator<Element>, 1024> copy(arena);
+    cubage::RegionArena<Element, std::allocator<Element>, 1024> assigned;
+    assigned.push_back(Element{-1.0});
+    assigned = arena;
+
+    bool equal = copy.size() == arena.size() && assigned.size() == arena.size()
+        && &copy[0] != &arena[0];
+    for (std::size_t i = 0; equal && i < arena.size(); ++i)
+        equal = copy[i] == arena[i] && assigned[i] == arena[i];
+    return equal;
+}
+
+int main()
+{
+    assert(growth_does_not_move_elements());
+    assert(clear_keeps_chunks_for_reuse());
+    assert(chunks_cover_all_elements_in_order());
+    assert(checkpoint_round_trip_restores_elements());
+    assert(read_rejects_count_beyond_data());
+    assert(copy_has_equal_elements_in_own_chunks());
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "region_queue.hpp"
+
+std::vector<cubage::RegionKey> random_keys(std::size_t count)
+{
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> exponent(-30.0, 0.0);
+    std::vector<cubage::RegionKey> keys(count);
+    for (std::size_t i = 0; i < count; ++i)
+        keys[i] = cubage::RegionKey{std::pow(10.0, exponent(gen)), i};
+    return keys;
+}
+
+template <cubage::RegionQueue QueueType>
+bool queue_pops_keys_in_descending_order()
+{
+    const auto keys = random_keys(1000);
+    QueueType queue{};
+    for (const auto& key : keys)
+        queue.push(key);
+
+    double previous = std::numeric_limits<double>::infinity();
+    while (!queue.empty())
+    {
+        const double top = queue.top().maxerr;
+        const cubage::RegionKey key = queue.pop();
+        if (key.maxerr != top || key.maxerr > previous)
+            return false;
+        previous = key.maxerr;
+    }
+    return true;
+}
+
+template <cubage::RegionQueue QueueType>
+bool queue_returns_every_key_once()
+{
+    const auto keys = random_keys(1000);
+    QueueType queue{};
+    std::vector<bool> popped(keys.size());
+
+    // interleave pushes and pops the way an adaptive integrator does
+    for (std::size_t i = 0; i < 10; ++i)
+        queue.push(keys[i]);
+    for (std::size_t i = 10; i + 1 < keys.size(); i += 2)
+    {
+        popped[queue.pop().index] = true;
+        queue.push(keys[i]);
+        queue.push(keys[i + 1]);
+    }
+    while (!queue.empty())
+        popped[queue.pop().index] = true;
+
+    return std::ranges::all_of(popped, [](bool x){ return x; });
+}
+
+bool bucket_queue_pops_key_within_factor_of_two_of_largest()
+{
+    const auto keys = random_keys(1000);
+    cubage::BucketQueue queue{};
+    std::vector<double> remaining;
+    for (const auto& key : keys)
+    {
+        queue.push(key);
+        remaining.push_back(key.maxerr);
+    }
+
+    while (!queue.empty())
+    {
+        const cubage::RegionKey key = queue.pop();
+        const auto largest = std::ranges::max_element(remaining);
+        if (2.0*key.maxerr < *largest)
+            return false;
+        remaining.erase(std::ranges::find(remaining, key.maxerr));
+    }
+    return true;
+}
+
+bool lazy_sort_queue_pops_sorted_keys_in_descending_order()
+{
+    // The first key is sorted on its own, since the queue is empty, and the
+    // remaining keys fill the buffer exactly, so all keys end up in runs.
+    const auto keys = random_keys(1 + 8*125);
+    cubage::LazySortQueue<8> queue{};
+    for (const auto& key : keys)
+        queue.push(key);
+
+    double previous = std::numeric_limits<double>::infinity();
+    std::size_t count = 0;
+    while (!queue.empty())
+    {
+        const cubage::RegionKey key = queue.pop();
+        if (key.maxerr > previous)
+            return false;
+        previous = key.maxerr;
+        ++count;
+    }
+    return count == keys.size();
+}
+
+int main()
+{
+    assert(queue_pops_keys_in_descending_order<cubage::BinaryHeapQueue>());
+    assert(queue_pops_keys_in_descending_order<cubage::QuaternaryHeapQueue>());
+    assert(queue_returns_every_key_once<cubage::BinaryHeapQueue>());
+    assert(queue_returns_every_key_once<cubage::QuaternaryHeapQueue>());
+    assert(queue_returns_every_key_once<cubage::BucketQueue>());
+    assert(queue_returns_every_key_once<cubage::LazySortQueue<16>>());
+    assert(bucket_queue_pops_key_within_factor_of_two_of_largest());
+    assert(lazy_sort_queue_pops_sorted_keys_in_descending_order());
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#include <cmath>
+
+#include "romberg.hpp"
+
+constexpr bool close(double a, double b, double tol)
+{
+    return std::fabs(a - b) < tol;
+}
+
+constexpr bool
+romberg_4_integrates_9th_degree_polynomial_exactly()
+{
+    using Rule = cubage::Romberg<double, double, 4>;
+    constexpr cubage::Interval<double> limits = {0.0, 1.0};
+
+    auto polynomial = [](double x)
+    {
+        const double x2 = x*x;
+        const double x4 = x2*x2;
+        const double x8 = x4*x4;
+        return x8*x + x4 + x;
+    };
+
+    const auto res = Rule::integrate(polynomial, limits);
+    return close(res.val, 1.0/10.0 + 1.0/5.0 + 1.0/2.0, 1.0e-14);
+}
+
+constexpr bool
+subdivided_interval_reuses_parent_values()
+{
+    using Rule = cubage::Romberg<double, double, 3>;
+    using Region = Rule::RegionType;
+
+    std::size_t count = 0;
+    auto function = [&](double x)
+    {
+        ++count;
+        return 1.0/(1.0 + x*x);
+    };
+
+    Region parent(0.0, 1.0);
+    [[maybe_unused]] const auto parent_res
+        = parent.integrate<Rule>(function);
+    const std::size_t parent_count = count;
+
+    auto [left, right] = parent.subdivide();
+    const auto left_res = left.integrate<Rule>(function);
+    const auto right_res = right.integrate<Rule>(function);
+    const std::size_t child_count = count - parent_count;
+
+    const auto left_ref = Rule::integrate(function, left.limits());
+    const auto right_ref = Rule::integrate(function, right.limits());
+
+    return parent_count == Rule::points_count()
+        && child_count == 2*Rule::subdivision_points_count()
+        && left_res.val == left_ref.val && left_res.err == left_ref.err
+        && right_res.val == right_ref.val && right_res.err == right_ref.err;
+}
+
+constexpr bool
+long_double_rule_is_exact_to_long_double_precision()
+{
+    using Rule = cubage::Romberg<long double, long double, 4>;
+    constexpr cubage::Interval<long double> limits = {0.0L, 1.0L/3.0L};
+
+    auto polynomial = [](long double x)
+    {
+        const long double x2 = x*x;
+        const long double x4 = x2*x2;
+        return x4*x4*x;
+    };
+
+    const auto res = Rule::integrate(polynomial, limits);
+    const long double x2 = limits.xmax*limits.xmax;
+    const long double x4 = x2*x2;
+    const long double expected = x4*x4*x2/10.0L;
+    const long double diff = res.val - expected;
+    return (diff < 0.0L ? -diff : diff) < 1.0e-18L*expected;
+}
+
+constexpr bool
+rule_evaluates_endpoints()
+{
+    using Rule = cubage::Romberg<double, double, 2>;
+    constexpr cubage::Interval<double> limits = {-1.0, 2.0};
+
+    bool evaluated_xmin = false;
+    bool evaluated_xmax = false;
+    auto function = [&](double x)
+    {
+        evaluated_xmin = evaluated_xmin || x == limits.xmin;
+        evaluated_xmax = evaluated_xmax || x == limits.xmax;
+        return x;
+    };
+
+    [[maybe_unused]] const auto res = Rule::integrate(function, limits);
+    return evaluated_xmin && evaluated_xmax;
+}
+
+static_assert(romberg_4_integrates_9th_degree_polynomial_exactly());
+static_assert(long_double_rule_is_exact_to_long_double_precision());
+static_assert(rule_evaluates_endpoints());
+static_assert(subdivided_interval_reuses_parent_values());
+
+int main()
+{
+    
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+/*
+Copyright (c) 2024 Sebastian Sassi
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of 
+this software and associated documentation files (the "Software"), to deal in 
+the Software without restriction, including without limitation the rights to 
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies 
+of the Software, and to permit persons to whom the Software is furnished to do 
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all 
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR 
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, 
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE 
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER 
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, 
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+SOFTWARE.
+*/
+#include <cassert>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "array_arithmetic.hpp"
+#include "box_region.hpp"
+#include "genz_malik.hpp"
+
+// This test is compiled with CUBAGE_SIMD defined.
+static_assert(cubage::simd::enabled);
+static_assert(cubage::simd::Dispatched<std::array<double, 64>>);
+static_assert(!cubage::simd::Dispatched<std::array<double, 3>>);
+static_assert(!cubage::simd::Dispatched<std::array<float, 64>>);
+
+constexpr bool close(double a, double b, double tol)
+{
+    return std::fabs(a - b) <= tol*std::fabs(b);
+}
+
+std::vector<double> random_values(std::size_t count, double min, double max)
+{
+    std::mt19937 gen(12345);
+    std::uniform_real_distribution<double> dist(min, max);
+    std::vector<double> values(count);
+    for (auto& value : values)
+        value = dist(gen);
+    return values;
+}
+
+// Compare the kernels of the instruction set with the scalar kernels for all
+// lengths up to 40, which covers all remainders of the vector widths.
+bool kernels_match_scalar_kernels(cubage::simd::InstructionSet instruction_set)
+{
+    const auto kernels = cubage::simd::make_kernel_table(instruction_set);
+    const auto reference = cubage::simd::make_kernel_table(
+            cubage::simd::InstructionSet::SCALAR);
+    const std::vector<double> a = random_values(40, -2.0, 2.0);
+    const std::vector<double> b = random_values(40, 0.5, 1.5);
+
+    for (std::size_t n = 0; n <= a.size(); ++n)
+    {
+        std::vector<double> x(a.begin(), a.begin() + std::ptrdiff_t(n));
+        std::vector<double> y = x;
+        kernels.add(x.data(), b.data(), n);
+        reference.add(y.data(), b.data(), n);
+        kernels.subtract(x.data(), a.data(), n);
+        reference.subtract(y.data(), a.data(), n);
+        kernels.multiply(x.data(), b.data(), n);
+        reference.multiply(y.data(), b.data(), n);
+        kernels.scale(x.data(), -0.5, n);
+        reference.scale(y.data(), -0.5, n);
+        if (x != y)
+            return false;
+
+        if (!close(kernels.abs_sum(a.data(), n), reference.abs_sum(a.data(), n), 1.0e-14)
+                || !close(kernels.product(b.data(), n), reference.product(b.data(), n), 1.0e-14))
+            return false;
+    }
+    return true;
+}
+
+bool dispatched_operators_match_plain_loops()
+{
+    using Array = std::array<double, 37>;
+    const std::vector<double> values = random_values(2*37, -1.0, 1.0);
+    Array a;
+    Array b;
+    std::copy(values.begin(), values.begin() + 37, a.begin());
+    std::copy(values.begin() + 37, values.end(), b.begin());
+
+    const Array res = 2.0*(a + b)*a - b;
+    double l1 = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i)
+    {
+        if (res[i] != 2.0*(a[i] + b[i])*a[i] - b[i])
+            return false;
+        l1 += std::fabs(res[i]);
+    }
+    return close(cubage::l1_norm(res), l1, 1.0e-14);
+}
+
+bool box_volume_matches_product_of_side_lengths()
+{
+    using Array = std::array<double, 20>;
+    cubage::Box<Array> box{};
+    double volume = 1.0;
+    for (std::size_t i = 0; i < box.xmax.size(); ++i)
+    {
+        box.xmin[i] = -0.5*double(i);
+        box.xmax[i] = 1.0;
+        volume *= box.xmax[i] - box.xmin[i];
+    }
+    return close(box.volume(), volume, 1.0e-14);
+}
+
+int main()
+{
+    using cubage::simd::InstructionSet;
+    const InstructionSet supported = cubage::simd::detect_instruction_set();
+    assert(cubage::simd::kernels().instruction_set == supported);
+    assert(kernels_match_scalar_kernels(InstructionSet::SCALAR));
+    if (supported == InstructionSet::AVX2 || supported == InstructionSet::AVX512)
+        assert(kernels_match_scalar_kernels(InstructionSet::AVX2));
+    if (supported == InstructionSet::AVX512)
+        assert(kernels_match_scalar_kernels(InstructionSet::AVX512));
+    assert(dispatched_operators_match_plain_loops());
+    assert(box_volume_matches_product_of_side_lengths());
+}
\ No newline at end of file